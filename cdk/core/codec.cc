@@ -28,11 +28,13 @@
 
 PUSH_SYS_WARNINGS
 #include <algorithm>  // std::min
+#include <cmath>      // std::pow
 POP_SYS_WARNINGS
 
 // Include Protobuf headers needed for decoding float numbers
 
 PUSH_PB_WARNINGS
+#include <mysql/cdk/foundation/varint.h>
 #include <google/protobuf/wire_format_lite.h>
 #include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 POP_PB_WARNINGS
@@ -101,9 +103,14 @@ foundation::api::String_codec* Format<TYPE_STRING>::codec() const
   static foundation::String_codec<foundation::codecvt_utf8>  utf8;
   static foundation::String_codec<foundation::codecvt_ascii> ascii;
 
-  return Charset::utf8 == charset() ?
-      (foundation::api::String_codec*)&utf8
-    : (foundation::api::String_codec*)&ascii;
+  switch (charset())
+  {
+  case Charset::utf8:
+  case Charset::utf8mb4:
+    return &utf8;
+  default:
+    return &ascii;
+  }
 }
 
 
@@ -128,15 +135,13 @@ struct zigzag<T, true>
       throw_error(cdkerrc::conversion_error,
                   "Codec<TYPE_INTEGER>: conversion overflow");
 
-    return google::protobuf::internal::WireFormatLite::ZigZagEncode64(
-             static_cast<int64_t>(val)
-           );
+    return foundation::varint::zigzag_encode(static_cast<int64_t>(val));
   }
 
   static
   T decode(uint64_t val)
   {
-    int64_t tmp = google::protobuf::internal::WireFormatLite::ZigZagDecode64(val);
+    int64_t tmp = foundation::varint::zigzag_decode(val);
 
     /*
       Note: to avoid singed/unsigned comparison we cast to uint64_t or
@@ -210,12 +215,9 @@ template <typename T>
 size_t Codec<TYPE_INTEGER>::internal_from_bytes(bytes buf, T &val)
 {
   uint64_t val_tmp;
+  size_t sz = foundation::varint::decode(buf, val_tmp);
 
-  assert(buf.size() < (size_t)std::numeric_limits<int>::max());
-
-  google::protobuf::io::CodedInputStream input_buffer(buf.begin(), (int)buf.size());
-
-  if (!input_buffer.ReadVarint64(&val_tmp))
+  if (0 == sz)
   {
     throw Error(cdkerrc::conversion_error,
                 "Codec<TYPE_INTEGER>: integer conversion error");
@@ -226,13 +228,53 @@ size_t Codec<TYPE_INTEGER>::internal_from_bytes(bytes buf, T &val)
   else
     val = zigzag_decode_signed<T>(val_tmp);
 
-  assert(input_buffer.CurrentPosition() >= 0);
-  size_t sz = static_cast<size_t>(input_buffer.CurrentPosition());
-
   return sz;
 }
 
 
+/*
+  Batch decoding of a column of integer fields. Raw varints are decoded
+  first and then converted to the target type according to the format.
+*/
+
+template <typename T>
+void Codec<TYPE_INTEGER>::internal_from_bytes(const bytes *fields,
+                                              size_t count, T *vals)
+{
+  static_assert(sizeof(T) == sizeof(uint64_t),
+                "batch decoding is done into 64-bit integers");
+
+  uint64_t *raw = reinterpret_cast<uint64_t*>(vals);
+
+  if (count != foundation::varint::decode(fields, count, raw))
+  {
+    throw Error(cdkerrc::conversion_error,
+                "Codec<TYPE_INTEGER>: integer conversion error");
+  }
+
+  if (m_fmt.is_unsigned())
+    for (size_t i = 0; i < count; ++i)
+      vals[i] = zigzag_decode_unsigned<T>(raw[i]);
+  else
+    for (size_t i = 0; i < count; ++i)
+      vals[i] = zigzag_decode_signed<T>(raw[i]);
+}
+
+
+void Codec<TYPE_INTEGER>::from_bytes(const bytes *fields, size_t count,
+                                     int64_t *vals)
+{
+  internal_from_bytes(fields, count, vals);
+}
+
+
+void Codec<TYPE_INTEGER>::from_bytes(const bytes *fields, size_t count,
+                                     uint64_t *vals)
+{
+  internal_from_bytes(fields, count, vals);
+}
+
+
 size_t Codec<TYPE_INTEGER>::from_bytes(bytes buf, int8_t &val)
 {
   return internal_from_bytes(buf, val);
@@ -353,10 +395,107 @@ size_t Codec<TYPE_INTEGER>::to_bytes(uint64_t val, bytes buf)
 }
 
 
+/*
+  Decoding of DECIMAL values. In X protocol, a DECIMAL value is encoded
+  as one byte holding the scale, followed by packed BCD digits (two per
+  byte, most significant first) and a sign nibble (0xC for positive,
+  0xD for negative values). If needed, the sign nibble is followed by
+  0x0 nibble to fill the last byte.
+
+  Function decode_bcd() walks through the digits, passing each of them
+  to `digit` callback. It returns the number of bytes consumed.
+*/
+
+template <class F>
+static
+size_t decode_bcd(bytes buf, unsigned &scale, bool &neg, F digit)
+{
+  const byte *pos = buf.begin();
+
+  if (buf.size() < 2)
+    throw cdk::Error(cdkerrc::conversion_error,
+                "Codec<TYPE_FLOAT>: invalid DECIMAL encoding");
+
+  scale = *pos++;
+
+  for (; pos < buf.end(); ++pos)
+  {
+    unsigned nibbles[2] = { (unsigned)(*pos >> 4), (unsigned)(*pos & 0x0F) };
+
+    for (unsigned nibble : nibbles)
+    {
+      if (nibble < 10)
+      {
+        digit(nibble);
+        continue;
+      }
+
+      switch (nibble)
+      {
+      case 0xC: neg = false; break;
+      case 0xD: neg = true; break;
+      default:
+        throw cdk::Error(cdkerrc::conversion_error,
+                    "Codec<TYPE_FLOAT>: invalid DECIMAL encoding");
+      }
+
+      return static_cast<size_t>(pos + 1 - buf.begin());
+    }
+  }
+
+  throw cdk::Error(cdkerrc::conversion_error,
+              "Codec<TYPE_FLOAT>: invalid DECIMAL encoding");
+}
+
+
+size_t Codec<TYPE_FLOAT>::from_bytes(bytes buf, Decimal &val)
+{
+  if (m_fmt.type() != cdk::Format<cdk::TYPE_FLOAT>::DECIMAL)
+    throw Error(cdkerrc::conversion_error,
+                "Codec<TYPE_FLOAT>: can not store FLOAT or DOUBLE value"
+                " into Decimal variable");
+
+  const uint64_t max = (uint64_t)std::numeric_limits<int64_t>::max();
+  uint64_t digits = 0;
+  bool neg = false;
+
+  size_t sz = decode_bcd(buf, val.m_scale, neg,
+    [&digits, max](unsigned d)
+    {
+      if (digits > (max - d) / 10)
+        throw Error(cdkerrc::conversion_error,
+                    "Codec<TYPE_FLOAT>: conversion overflow");
+      digits = 10*digits + d;
+    });
+
+  val.m_val = neg ? -(int64_t)digits : (int64_t)digits;
+  return sz;
+}
+
+
+void Codec<TYPE_FLOAT>::from_bytes(const bytes *fields, size_t count,
+                                   Decimal *vals)
+{
+  for (size_t i = 0; i < count; ++i)
+    from_bytes(fields[i], vals[i]);
+}
+
+
+Decimal::operator double() const
+{
+  return (double)m_val / std::pow(10.0, (double)m_scale);
+}
+
+
 size_t Codec<TYPE_FLOAT>::from_bytes(bytes buf, float &val)
 {
   if (m_fmt.type() == cdk::Format<cdk::TYPE_FLOAT>::DECIMAL)
-    THROW("Codec<TYPE_FOAT>: DECIMAL format not supported yet");
+  {
+    double val_tmp;
+    size_t sz = from_bytes(buf, val_tmp);
+    val = (float)val_tmp;
+    return sz;
+  }
 
   if (m_fmt.type() == cdk::Format<cdk::TYPE_FLOAT>::DOUBLE)
     throw Error(cdkerrc::conversion_error,
@@ -378,7 +517,24 @@ size_t Codec<TYPE_FLOAT>::from_bytes(bytes buf, float &val)
 size_t Codec<TYPE_FLOAT>::from_bytes(bytes buf, double &val)
 {
   if (m_fmt.type() == cdk::Format<cdk::TYPE_FLOAT>::DECIMAL)
-    THROW("Codec<TYPE_FOAT>: DECIMAL format not supported yet");
+  {
+    /*
+      Note: digits are accumulated in a double so that values which
+      do not fit in Decimal can still be converted.
+    */
+
+    double digits = 0;
+    unsigned scale;
+    bool neg = false;
+
+    size_t sz = decode_bcd(buf, scale, neg,
+      [&digits](unsigned d) { digits = 10*digits + d; });
+
+    val = digits / std::pow(10.0, (double)scale);
+    if (neg)
+      val = -val;
+    return sz;
+  }
 
   size_t sz;
 
@@ -420,12 +576,139 @@ size_t Codec<TYPE_FLOAT>::to_bytes(double val, bytes buf)
 }
 
 
+/*
+  Decoding of temporal values. In X protocol, DATETIME and TIMESTAMP
+  values are encoded as a sequence of varints: year, month, day and,
+  optionally, hour, minutes, seconds and microseconds. TIME values are
+  encoded as sign byte (0x01 for negative values) followed by varints:
+  hours and, optionally, minutes, seconds and microseconds.
+
+  Function decode_varints() decodes up to `max` varints, storing them
+  in `vals` array. It returns number of decoded varints and sets `pos`
+  to the first byte after them.
+*/
+
+static
+unsigned decode_varints(const byte *&pos, const byte *end,
+                        uint64_t *vals, unsigned max)
+{
+  unsigned cnt = 0;
+
+  for (; cnt < max && pos < end; ++cnt)
+  {
+    size_t len = foundation::varint::decode(pos, end, vals[cnt]);
+    if (0 == len)
+      throw cdk::Error(cdkerrc::conversion_error,
+                  "Codec<TYPE_DATETIME>: invalid encoding of temporal value");
+    pos += len;
+  }
+
+  return cnt;
+}
+
+
+size_t Codec<TYPE_DATETIME>::from_bytes(bytes buf, Datetime &val)
+{
+  if (Format<TYPE_DATETIME>::TIME == m_fmt.type())
+    throw Error(cdkerrc::conversion_error,
+                "Codec<TYPE_DATETIME>: can not store TIME value"
+                " into Datetime variable");
+
+  const byte *pos = buf.begin();
+  uint64_t parts[7] = { 0, 0, 0, 0, 0, 0, 0 };
+
+  if (decode_varints(pos, buf.end(), parts, 7) < 3)
+    throw Error(cdkerrc::conversion_error,
+                "Codec<TYPE_DATETIME>: invalid encoding of temporal value");
+
+  val.m_year   = (unsigned)parts[0];
+  val.m_month  = (unsigned)parts[1];
+  val.m_day    = (unsigned)parts[2];
+  val.m_hour   = (unsigned)parts[3];
+  val.m_minute = (unsigned)parts[4];
+  val.m_second = (unsigned)parts[5];
+  val.m_usec   = (unsigned)parts[6];
+
+  return static_cast<size_t>(pos - buf.begin());
+}
+
+
+size_t Codec<TYPE_DATETIME>::from_bytes(bytes buf, Time &val)
+{
+  if (Format<TYPE_DATETIME>::TIME != m_fmt.type())
+    throw Error(cdkerrc::conversion_error,
+                "Codec<TYPE_DATETIME>: can not store DATETIME value"
+                " into Time variable");
+
+  const byte *pos = buf.begin();
+  uint64_t parts[4] = { 0, 0, 0, 0 };
+
+  if (pos >= buf.end() || *pos > 1)
+    throw Error(cdkerrc::conversion_error,
+                "Codec<TYPE_DATETIME>: invalid encoding of temporal value");
+
+  val.m_negative = (1 == *pos++);
+
+  decode_varints(pos, buf.end(), parts, 4);
+
+  val.m_hours   = (unsigned)parts[0];
+  val.m_minutes = (unsigned)parts[1];
+  val.m_seconds = (unsigned)parts[2];
+  val.m_usec    = (unsigned)parts[3];
+
+  return static_cast<size_t>(pos - buf.begin());
+}
+
+
+void Codec<TYPE_DATETIME>::from_bytes(const bytes *fields, size_t count,
+                                      Datetime *vals)
+{
+  for (size_t i = 0; i < count; ++i)
+    from_bytes(fields[i], vals[i]);
+}
+
+
+void Codec<TYPE_DATETIME>::from_bytes(const bytes *fields, size_t count,
+                                      Time *vals)
+{
+  for (size_t i = 0; i < count; ++i)
+    from_bytes(fields[i], vals[i]);
+}
+
+
+/*
+  Conversion from civil date to number of days since 1970-01-01.
+  See: http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+*/
+
+int64_t Datetime::epoch() const
+{
+  int64_t y = (int64_t)m_year - (m_month <= 2 ? 1 : 0);
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  int64_t yoe = y - era * 400;
+  int64_t mp = (m_month + 9) % 12;
+  int64_t doy = (153 * mp + 2) / 5 + m_day - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  int64_t days = era * 146097 + doe - 719468;
+
+  return days * 86400 + m_hour * 3600 + m_minute * 60 + m_second;
+}
+
+
+int64_t Time::usec() const
+{
+  int64_t val = ((int64_t)m_hours * 3600 + m_minutes * 60 + m_seconds)
+                * 1000000 + m_usec;
+  return m_negative ? -val : val;
+}
+
+
 size_t Codec<TYPE_DOCUMENT>::from_bytes(bytes data, JSON::Processor &jp)
 {
-  std::string json_string(data.begin(), data.end());
-  JSON_parser parser(json_string);
+  // Note: parser works directly on the UTF-8 bytes, without copying them.
+  JSON_utf8_parser parser(data);
   parser.process(jp);
-  return 0; // FIXME
+  return data.size();
 }
 
 Codec<TYPE_DOCUMENT>::Doc_format Codec<TYPE_DOCUMENT>::m_format;
@@ -30,26 +30,23 @@
 namespace cdk {
 
 
-Session::Session(ds::TCPIP &ds, const ds::TCPIP::Options &options)
-  : m_session(NULL)
-  , m_connection(NULL)
-  , m_trans(false)
+/*
+  Start a session over a connection that has already been established.
+
+  If requested by the options, TLS is negotiated first and the session
+  runs over the TLS layer wrapped around the given connection. On return
+  `conn` holds the connection object owned by the session. If TLS handshake
+  fails, `tls_failed` is set to true and the error is thrown - in that case
+  the given connection is already deleted.
+*/
+
+template <class C>
+static
+mysqlx::Session* start_session(C *connection,
+                               const ds::TCPIP::Options &options,
+                               api::Connection* &conn,
+                               bool &tls_failed)
 {
-  using foundation::connection::TCPIP;
-  using foundation::connection::TCPIP_base;
-
-  TCPIP* connection = new TCPIP(ds.host(), ds.port());
-  try
-  {
-    connection->connect();
-  }
-  catch (...)
-  {
-    delete connection;
-    rethrow_error();
-  }
-
-
 #ifdef WITH_SSL
   if (options.get_tls().use_tls())
   {
@@ -83,19 +80,103 @@ Session::Session(ds::TCPIP &ds, const ds::TCPIP::Options &options)
 
     TLS* tls = new TLS(connection, options.get_tls());
 
-    tls->connect();
-    m_connection = tls;
-    m_session = new mysqlx::Session(*tls, options);
+    try
+    {
+      tls->connect();
+    }
+    catch (...)
+    {
+      delete tls;
+      tls_failed = true;
+      throw;
+    }
+
+    conn = tls;
+    return new mysqlx::Session(*tls, options);
   }
-  else
 #endif
+
+  conn = connection;
+  return new mysqlx::Session(*connection, options);
+}
+
+
+/*
+  Create a connection using `make_conn`, connect it and start a session
+  over it.
+
+  If TLS handshake fails, this is attempted once more over a new connection.
+  A failed handshake which tried to resume a cached TLS session removes
+  that session from the cache, so that the second attempt does a full
+  handshake. This way a stale session (for example, after the server behind
+  the same address has changed) does not cause connection failure. This
+  can not be done by the TLS layer itself because TLS is started only after
+  capabilities are negotiated over the plain connection.
+*/
+
+template <class C, class F>
+static
+mysqlx::Session* open_session(F make_conn,
+                              const ds::TCPIP::Options &options,
+                              api::Connection* &conn)
+{
+  for (unsigned attempt = 0;; ++attempt)
   {
-    m_connection = connection;
-    m_session = new mysqlx::Session(*connection, options);
+    C* connection = make_conn();
+    try
+    {
+      connection->connect();
+    }
+    catch (...)
+    {
+      delete connection;
+      rethrow_error();
+    }
+
+    bool tls_failed = false;
+
+    try
+    {
+      return start_session(connection, options, conn, tls_failed);
+    }
+    catch (...)
+    {
+      if (!tls_failed || attempt > 0)
+        throw;
+    }
   }
 }
 
 
+Session::Session(const ds::TCPIP &ds, const ds::TCPIP::Options &options)
+  : m_session(NULL)
+  , m_connection(NULL)
+  , m_trans(false)
+{
+  using foundation::connection::TCPIP;
+
+  m_session = open_session<TCPIP>(
+    [&ds]() { return new TCPIP(ds.host(), ds.port()); },
+    options, m_connection
+  );
+}
+
+
+Session::Session(const ds::Unix_socket &ds,
+                 const ds::Unix_socket::Options &options)
+  : m_session(NULL)
+  , m_connection(NULL)
+  , m_trans(false)
+{
+  using foundation::connection::Unix_socket;
+
+  m_session = open_session<Unix_socket>(
+    [&ds]() { return new Unix_socket(ds.path()); },
+    options, m_connection
+  );
+}
+
+
 Session::~Session()
 {
   if (m_trans)
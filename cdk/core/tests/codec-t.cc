@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This code is licensed under the terms of the GPLv2
+ * <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+ * MySQL Connectors. There are special exceptions to the terms and
+ * conditions of the GPLv2 as it is applied to this software, see the
+ * FLOSS License Exception
+ * <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+
+/*
+  Unit tests for decoding of DECIMAL and temporal values. Values are
+  encoded by hand, as they would be sent by server, so that these tests
+  do not require a server.
+*/
+
+#include "test.h"
+#include <mysql/cdk.h>
+
+using namespace ::cdk;
+
+
+/*
+  Format description of a DECIMAL or temporal column.
+*/
+
+class Test_format : public Format_info
+{
+  Format<TYPE_DATETIME>::Fmt m_fmt;
+
+public:
+
+  Test_format(Format<TYPE_DATETIME>::Fmt fmt = Format<TYPE_DATETIME>::DATETIME)
+    : m_fmt(fmt)
+  {}
+
+  bool for_type(Type_info type) const
+  {
+    return TYPE_FLOAT == type || TYPE_DATETIME == type;
+  }
+
+private:
+
+  using Format_info::get_info;
+
+  void get_info(Format<TYPE_FLOAT> &fmt) const
+  {
+    Format<TYPE_FLOAT>::Access::set_fmt(fmt, Format<TYPE_FLOAT>::DECIMAL);
+  }
+
+  void get_info(Format<TYPE_DATETIME> &fmt) const
+  {
+    Format<TYPE_DATETIME>::Access::set_fmt(fmt, m_fmt, true);
+  }
+};
+
+
+#define BUF(X) bytes((byte*)X, sizeof(X) - 1)
+
+
+TEST(Codec, decimal)
+{
+  Test_format fmt;
+  Codec<TYPE_FLOAT> codec(fmt);
+  Decimal dec;
+  double val;
+
+  // Odd number of digits: 3.14, sign nibble fills the last byte.
+
+  EXPECT_EQ(3, codec.from_bytes(BUF("\x02\x31\x4C"), dec));
+  EXPECT_EQ(314, dec.m_val);
+  EXPECT_EQ(2, dec.m_scale);
+  EXPECT_EQ(3.14, (double)dec);
+
+  EXPECT_EQ(3, codec.from_bytes(BUF("\x02\x31\x4C"), val));
+  EXPECT_EQ(3.14, val);
+
+  // Even number of digits: -12.34, followed by 0x0 filler nibble.
+
+  EXPECT_EQ(4, codec.from_bytes(BUF("\x02\x12\x34\xD0"), dec));
+  EXPECT_EQ(-1234, dec.m_val);
+  EXPECT_EQ(2, dec.m_scale);
+
+  EXPECT_EQ(4, codec.from_bytes(BUF("\x02\x12\x34\xD0"), val));
+  EXPECT_EQ(-12.34, val);
+
+  float fval;
+  codec.from_bytes(BUF("\x00\x7D"), fval);
+  EXPECT_EQ(-7.0f, fval);
+
+  // Bytes after the encoded value are not consumed.
+
+  EXPECT_EQ(2, codec.from_bytes(BUF("\x00\x7C\x99"), dec));
+  EXPECT_EQ(7, dec.m_val);
+  EXPECT_EQ(0, dec.m_scale);
+
+  // Largest value which fits into Decimal.
+
+  const char max[] = "\x00\x92\x23\x37\x20\x36\x85\x47\x75\x80\x7C";
+
+  codec.from_bytes(BUF(max), dec);
+  EXPECT_EQ(std::numeric_limits<int64_t>::max(), dec.m_val);
+
+  // Values which do not fit into Decimal can still be read as double.
+
+  const char big[] = "\x01\x99\x99\x99\x99\x99\x99\x99\x99\x99\x99\xC0";
+
+  EXPECT_THROW(codec.from_bytes(BUF(big), dec), Error);
+  EXPECT_NO_THROW(codec.from_bytes(BUF(big), val));
+  EXPECT_DOUBLE_EQ(1e19, val);
+
+  // Truncated and invalid encodings.
+
+  EXPECT_THROW(codec.from_bytes(BUF(""), dec), Error);
+  EXPECT_THROW(codec.from_bytes(BUF("\x02"), dec), Error);
+  EXPECT_THROW(codec.from_bytes(BUF("\x02\x31\x41"), dec), Error);
+  EXPECT_THROW(codec.from_bytes(BUF("\x02\x31\x41"), val), Error);
+  EXPECT_THROW(codec.from_bytes(BUF("\x00\x1A"), dec), Error);
+
+  // Batch decoding.
+
+  bytes fields[] = { BUF("\x02\x31\x4C"), BUF("\x02\x12\x34\xD0") };
+  Decimal vals[2];
+
+  codec.from_bytes(fields, 2, vals);
+  EXPECT_EQ(314, vals[0].m_val);
+  EXPECT_EQ(-1234, vals[1].m_val);
+}
+
+
+TEST(Codec, datetime)
+{
+  Test_format fmt(Format<TYPE_DATETIME>::DATETIME);
+  Codec<TYPE_DATETIME> codec(fmt);
+  Datetime dt;
+
+  // 2016-02-29 13:45:07.123456
+
+  const char full[] = "\xE0\x0F\x02\x1D\x0D\x2D\x07\xC0\xC4\x07";
+
+  EXPECT_EQ(10, codec.from_bytes(BUF(full), dt));
+  EXPECT_EQ(2016, dt.m_year);
+  EXPECT_EQ(2, dt.m_month);
+  EXPECT_EQ(29, dt.m_day);
+  EXPECT_EQ(13, dt.m_hour);
+  EXPECT_EQ(45, dt.m_minute);
+  EXPECT_EQ(7, dt.m_second);
+  EXPECT_EQ(123456, dt.m_usec);
+  EXPECT_EQ(1456753507, dt.epoch());
+
+  // Date only - time part is 0.
+
+  EXPECT_EQ(4, codec.from_bytes(BUF("\xE0\x0F\x02\x1D"), dt));
+  EXPECT_EQ(29, dt.m_day);
+  EXPECT_EQ(0, dt.m_hour);
+  EXPECT_EQ(0, dt.m_usec);
+
+  // Truncated values.
+
+  EXPECT_THROW(codec.from_bytes(BUF("\xE0\x0F\x02"), dt), Error);
+  EXPECT_THROW(codec.from_bytes(BUF("\xE0\x0F\x02\x1D\x8D"), dt), Error);
+  EXPECT_THROW(codec.from_bytes(BUF("\xE0"), dt), Error);
+
+  // DATETIME value can not be stored in Time.
+
+  Time time;
+  EXPECT_THROW(codec.from_bytes(BUF(full), time), Error);
+
+  // Batch decoding.
+
+  bytes fields[] = { BUF(full), BUF("\xE0\x0F\x02\x1D") };
+  Datetime vals[2];
+
+  codec.from_bytes(fields, 2, vals);
+  EXPECT_EQ(7, vals[0].m_second);
+  EXPECT_EQ(0, vals[1].m_second);
+}
+
+
+TEST(Codec, time)
+{
+  Test_format fmt(Format<TYPE_DATETIME>::TIME);
+  Codec<TYPE_DATETIME> codec(fmt);
+  Time time;
+
+  // -838:59:58
+
+  EXPECT_EQ(5, codec.from_bytes(BUF("\x01\xC6\x06\x3B\x3A"), time));
+  EXPECT_TRUE(time.m_negative);
+  EXPECT_EQ(838, time.m_hours);
+  EXPECT_EQ(59, time.m_minutes);
+  EXPECT_EQ(58, time.m_seconds);
+  EXPECT_EQ(0, time.m_usec);
+  EXPECT_EQ(-(838*3600 + 59*60 + 58)*1000000LL, time.usec());
+
+  // 12:34 (trailing parts which are 0 can be omitted)
+
+  EXPECT_EQ(3, codec.from_bytes(BUF("\x00\x0C\x22"), time));
+  EXPECT_FALSE(time.m_negative);
+  EXPECT_EQ(12, time.m_hours);
+  EXPECT_EQ(34, time.m_minutes);
+  EXPECT_EQ(0, time.m_seconds);
+  EXPECT_EQ((12*3600 + 34*60)*1000000LL, time.usec());
+
+  // Invalid sign byte, missing sign byte and truncated varint.
+
+  EXPECT_THROW(codec.from_bytes(BUF("\x02\x0C"), time), Error);
+  EXPECT_THROW(codec.from_bytes(BUF(""), time), Error);
+  EXPECT_THROW(codec.from_bytes(BUF("\x00\x8C"), time), Error);
+
+  // TIME value can not be stored in Datetime.
+
+  Datetime dt;
+  EXPECT_THROW(codec.from_bytes(BUF("\x00\x0C\x22"), dt), Error);
+}
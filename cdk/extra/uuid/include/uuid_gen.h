@@ -19,6 +19,7 @@
 #define _UUID_GEN_H_
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define UUID_LENGTH_BIN 16
 
@@ -36,6 +37,13 @@ void set_seed_from_time_pid();
 /* UUID generator */
 void generate_uuid(uuid_type &uuid);
 
+/* Generate count UUIDs at once, reading system time only once */
+void generate_uuids(uuid_type *uuids, size_t count);
+
+/* Write UUID as 2*UUID_LENGTH_BIN upper-case hex digits (no terminating
+   null character) */
+void to_hex(const uuid_type &uuid, char *buf);
+
 } // namespace uuid
 
 #endif
\ No newline at end of file
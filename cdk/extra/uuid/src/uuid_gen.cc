@@ -25,25 +25,11 @@
 #endif
 #include <algorithm>
 #include <stdexcept>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
-#ifdef _WIN32
-
-typedef CRITICAL_SECTION pthread_mutex_t;
-typedef DWORD		 pthread_t;
-typedef struct thread_attr {
-  DWORD dwStackSize;
-  DWORD dwCreatingFlag;
-} pthread_attr_t;
-
-#define pthread_getspecific(A) (TlsGetValue(A))
-#define pthread_self() (GetCurrentThreadId())
-#define pthread_mutex_init(A,B)  (InitializeCriticalSection(A),0)
-#define pthread_mutex_lock(A)	 (EnterCriticalSection(A),0)
-#define pthread_mutex_trylock(A) win_pthread_mutex_trylock((A))
-#define pthread_mutex_unlock(A)  (LeaveCriticalSection(A), 0)
-#define pthread_mutex_destroy(A) (DeleteCriticalSection(A), 0)
-
-#else
+#ifndef _WIN32
 
 #include <unistd.h>
 #include <fstream>
@@ -51,7 +37,19 @@ typedef struct thread_attr {
 
 #endif
 
-#define MY_MUTEX_INIT_FAST   NULL
+/*
+  Thread local storage. Older MSVC versions do not support C++11
+  thread_local, but can store POD types in thread local variables.
+  Without thread_local there is no way to run code at thread exit and
+  thread indexes are not recycled (see get_state()).
+*/
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define UUID_THREAD_LOCAL __declspec(thread)
+#define UUID_NO_THREAD_EXIT
+#else
+#define UUID_THREAD_LOCAL thread_local
+#endif
 
 /*
   The macros below are borrowed from include/linux/compiler.h in the
@@ -69,30 +67,136 @@ typedef struct thread_attr {
 #define likely(x)	__builtin_expect((x),1)
 #define unlikely(x)	__builtin_expect((x),0)
 
-static pthread_mutex_t LOCK_uuid_generator;
+/*
+  Generator state
+  ===============
+
+  Generating UUIDs does not use any shared lock. Each thread has its own
+  generator state (Thread_state below) which holds the last used time
+  value, the clock sequence and the random number generator seed.
+
+  All threads share the same node part, which is randomly generated when
+  seed is set, except that the thread index is XOR-ed into its last two
+  bytes. This way UUIDs generated by different threads of the same process
+  always differ even if they are generated at the same time.
+
+  Thread indexes are 16 bit, so they must be unique only among running
+  threads. When a thread exits, its state (with the index) is returned
+  to the free list and can be re-used by a new thread, which continues
+  from the last time value used by the exited one. Fresh indexes are
+  used only when the free list is empty.
+
+  Setting the seed increases global seed version. A thread notices the
+  change when it generates its next UUID and re-initializes its state.
+*/
 
-/* The seed and the random value are stored in uuid_seed */
-static uint16_t uuid_seed = 0;
+/* Mutex serializing set_seed() calls */
+static std::mutex seed_lock;
 
-/* Needed for the time counting */
-static unsigned int nanoseq = 0;
+/*
+  Global seed (lower 16 bits) and seed version (upper 16 bits). Version 0
+  means that the seed was not set yet.
+*/
+static std::atomic<uint32_t> seed_global(0);
 
-/* The last used time value is stored here */
-static unsigned long long uuid_time2 = 0;
+/*
+  The randomly generated node part is stored here (in the lower 48 bits).
+  It is generated only when the seed is changed.
+*/
+static std::atomic<uint64_t> node_global(0);
+
+/*
+  Mutex protecting the free list of thread states and the next never used
+  thread index (indexes wrap around only if more than 65536 threads
+  generate UUIDs at the same time).
+*/
+static std::mutex index_lock;
+static uint16_t thread_count = 0;
 
 #if defined(_WIN32)
 static unsigned long long query_performance_frequency = 0;
 static unsigned long long query_performance_offset = 0;
 #endif
 
-static uint16_t time_seq_global = 0;
+/*
+  Note: this is a POD type so that it can be stored in thread local
+  variable also with older compilers. Zero-initialized state has version 0
+  and is initialized on first use.
+*/
+
+struct Thread_state
+{
+  uint32_t  version;
+  uint16_t  index;
+  bool      has_index;
+
+  /* The seed and the random value are stored in seed */
+  uint16_t  seed;
+
+  /* Needed for the time counting */
+  unsigned int nanoseq;
+
+  /* The last used time value is stored here */
+  unsigned long long last_time;
+
+  uint16_t  time_seq;
+  unsigned char node[6];
+};
+
+static UUID_THREAD_LOCAL Thread_state thread_state;
+
+/* States of exited threads, protected by index_lock */
+static std::vector<Thread_state> free_states;
+
 
 /*
-  The randomly generated node part is stored here.
-  It is generated only when the seed is changed.
-  All other times it is just re-used.
+  Assign thread index to the given state. If the index is taken from
+  an exited thread, its whole state is taken over so that UUIDs it has
+  generated (possibly with time values ahead of the current time) are
+  not repeated.
 */
-unsigned char node_global[6];
+
+static void acquire_index(Thread_state &state)
+{
+  std::lock_guard<std::mutex> guard(index_lock);
+
+  if (free_states.empty())
+    state.index = thread_count++;
+  else
+  {
+    state = free_states.back();
+    free_states.pop_back();
+  }
+
+  state.has_index = true;
+}
+
+
+#ifndef UUID_NO_THREAD_EXIT
+
+/*
+  Returns thread state to the free list when thread exits. It is
+  a separate object because Thread_state must stay a POD type.
+*/
+
+struct Index_release
+{
+  bool active;
+
+  ~Index_release()
+  {
+    if (!active || !thread_state.has_index)
+      return;
+
+    std::lock_guard<std::mutex> guard(index_lock);
+    free_states.push_back(thread_state);
+    thread_state.has_index = false;
+  }
+};
+
+static thread_local Index_release index_release;
+
+#endif
 
 /**
   number of 100-nanosecond intervals between
@@ -107,12 +211,12 @@ unsigned char node_global[6];
 #define UUID_VARIANT      0x8000
 
 /* Generate pseudo-random values using Fibonaccy sequence */
-uint16_t rand_fibonacci()
+static uint16_t rand_fibonacci(uint16_t &seed)
 {
-  uint16_t bit = ((uuid_seed >> 0) ^ (uuid_seed >> 2) ^
-                  (uuid_seed >> 3) ^ (uuid_seed >> 5)) & 1;
-  uuid_seed = (uuid_seed >> 1) | (bit << 15);
-  return uuid_seed;
+  uint16_t bit = ((seed >> 0) ^ (seed >> 2) ^
+                  (seed >> 3) ^ (seed >> 5)) & 1;
+  seed = (seed >> 1) | (bit << 15);
+  return seed;
 }
 
 
@@ -150,77 +254,41 @@ static uint32_t get_proc_id()
 #endif
 }
 
-/* Do initialization for UUID generator */
-void init_uuid()
-{
-  pthread_mutex_init(&LOCK_uuid_generator, MY_MUTEX_INIT_FAST);
-  uuid_seed = 0;
 
 #if defined(_WIN32)
-  FILETIME ft;
-  LARGE_INTEGER li, t_cnt;
-
-  if (QueryPerformanceFrequency((LARGE_INTEGER *)&query_performance_frequency) == 0)
-    query_performance_frequency = 0;
-  else
-  {
-    GetSystemTimeAsFileTime(&ft);
-    li.LowPart = ft.dwLowDateTime;
-    li.HighPart = ft.dwHighDateTime;
-    query_performance_offset = li.QuadPart - UUID_TIME_OFFSET;
-    QueryPerformanceCounter(&t_cnt);
-    query_performance_offset -= (t_cnt.QuadPart /
-                                 query_performance_frequency * UUID_MS +
-                                 t_cnt.QuadPart %
-                                 query_performance_frequency * UUID_MS /
-                                 query_performance_frequency);
-  }
-#endif
-
-}
-
-
-void deinit_uuid()
-{
-  pthread_mutex_destroy(&LOCK_uuid_generator);
-}
-
 
 /*
-  Instance of this class holds the global UUID generator mutex until
-  it gets destroyed. An exception-safe way of executing a block of code while
-  holding the mutex is like follows:
-
-    {
-      Uuid_guard guard;
-      // code executed under the guard of the global mutex
-    }
+  Initialization of high resolution timer on Windows. It is done once,
+  when the library is loaded, by the static instance of Timer_init.
 */
 
-struct Uuid_guard
+static struct Timer_init
 {
-  struct Initializer
+  Timer_init()
   {
-    Initializer() { init_uuid(); }
-    ~Initializer() { deinit_uuid(); }
-  };
+    FILETIME ft;
+    LARGE_INTEGER li, t_cnt;
 
-  Uuid_guard()
-  {
-    /*
-      This static initializer instance gets constructed only once.
-      It ensures that uuid module is properly initialized before
-      using the mutex.
-    */
-    static Initializer init;
-    pthread_mutex_lock(&LOCK_uuid_generator);
+    if (QueryPerformanceFrequency((LARGE_INTEGER *)&query_performance_frequency) == 0)
+      query_performance_frequency = 0;
+    else
+    {
+      GetSystemTimeAsFileTime(&ft);
+      li.LowPart = ft.dwLowDateTime;
+      li.HighPart = ft.dwHighDateTime;
+      query_performance_offset = li.QuadPart - UUID_TIME_OFFSET;
+      QueryPerformanceCounter(&t_cnt);
+      query_performance_offset -= (t_cnt.QuadPart /
+                                   query_performance_frequency * UUID_MS +
+                                   t_cnt.QuadPart %
+                                   query_performance_frequency * UUID_MS /
+                                   query_performance_frequency);
+    }
   }
+}
+timer_init;
 
-  ~Uuid_guard()
-  {
-    pthread_mutex_unlock(&LOCK_uuid_generator);
-  }
-};
+#endif
 
 
 /*
@@ -237,60 +305,85 @@ struct uuid_internal_st
   uint32_t time_low;
 };
 
-/* Random generation of the node part in UUID */
-void generate_node()
+
+/*
+  Return generator state of the current thread, (re-)initializing it
+  if the seed has changed since it was last used.
+*/
+
+static Thread_state& get_state()
 {
-  uint16_t i = 0;
-  uint16_t rand_buf[3];
+  Thread_state &state = thread_state;
+  uint32_t seed = seed_global.load(std::memory_order_acquire);
 
-  /* Run a few steps through the sequence */
-  i = rand_fibonacci() & 7;
-  while (i && rand_fibonacci()) --i;
+  if (likely(state.version == seed && seed))
+    return state;
 
-  for (i = 0; i < 3; i++)
+  if (!(seed >> 16))
+    throw std::logic_error("The seed must be set for random numbers generator");
+
+  if (!state.has_index)
   {
-    rand_buf[i] = rand_fibonacci();
+    acquire_index(state);
+#ifndef UUID_NO_THREAD_EXIT
+    index_release.active = true;
+#endif
+    if (state.version == seed)
+      return state;
   }
 
-  memcpy(node_global, rand_buf, sizeof(node_global));
-  time_seq_global = rand_fibonacci();
-}
+  uint64_t node = node_global.load(std::memory_order_relaxed);
+  node ^= (uint64_t)state.index << 32;
+  memcpy(state.node, &node, sizeof(state.node));
 
+  /*
+    Each thread uses different random sequence (note that LFSR seed must
+    not be 0).
+  */
 
-namespace uuid
-{
+  state.seed = (uint16_t)(seed ^ (state.index * 0x9E37u));
+  if (!state.seed)
+    state.seed = 0xACE1;
 
-void generate_uuid(uuid_type &uuid)
-{
-  if (!uuid_seed)
-    throw std::logic_error("The seed must be set for random numbers generator");
+  state.time_seq = rand_fibonacci(state.seed);
+  state.nanoseq = 0;
+  state.last_time = 0;
+  state.version = seed;
 
-  uuid_internal_st uuid_internal;
+  return state;
+}
 
-  Uuid_guard guard;
 
-  unsigned long long tv = my_getsystime() + UUID_TIME_OFFSET + nanoseq;
+/*
+  Compute time value for the next UUID, given the current time `now`
+  (with UUID_TIME_OFFSET already added).
+*/
+
+static unsigned long long next_time(Thread_state &state, unsigned long long now)
+{
+  unsigned long long tv = now + state.nanoseq;
 
-  if (likely(tv > uuid_time2))
+  if (likely(tv > state.last_time))
   {
     /*
       Current time is ahead of last timestamp, as it should be.
       If we "borrowed time", give it back, just as long as we
       stay ahead of the previous timestamp.
     */
-    if (nanoseq)
+    if (state.nanoseq)
     {
       /*
         -1 so we won't make tv= uuid_time for nanoseq >= (tv - uuid_time)
       */
-      unsigned long delta = std::min<unsigned long>(nanoseq, (unsigned long)(tv - uuid_time2 - 1));
+      unsigned long delta = std::min<unsigned long>(state.nanoseq,
+                              (unsigned long)(tv - state.last_time - 1));
       tv -= delta;
-      nanoseq -= delta;
+      state.nanoseq -= delta;
     }
   }
   else
   {
-    if (unlikely(tv == uuid_time2))
+    if (unlikely(tv == state.last_time))
     {
       /*
         For low-res system clocks. If several requests for UUIDs
@@ -303,11 +396,11 @@ void generate_uuid(uuid_type &uuid)
         (so the if() below is needed so we can avoid the ++tv and thus
         match the follow-up if() if nanoseq overflows!).
       */
-      if (likely(++nanoseq))
+      if (likely(++state.nanoseq))
         ++tv;
     }
 
-    if (unlikely(tv <= uuid_time2))
+    if (unlikely(tv <= state.last_time))
     {
       /*
         If the admin changes the system clock (or due to Daylight
@@ -320,29 +413,111 @@ void generate_uuid(uuid_type &uuid)
         irrelevant in the new numberspace.
       */
       tv = my_getsystime() + UUID_TIME_OFFSET;
-      time_seq_global = rand_fibonacci() | UUID_VARIANT;
+      state.time_seq = rand_fibonacci(state.seed) | UUID_VARIANT;
 
-      nanoseq = 0;
+      state.nanoseq = 0;
     }
   }
 
-  uuid_time2 = tv;
+  state.last_time = tv;
+  return tv;
+}
+
+
+static void store_uuid(uuid::uuid_type &uuid, const Thread_state &state,
+                       unsigned long long tv)
+{
+  uuid_internal_st uuid_internal;
 
   uuid_internal.time_low = (uint32_t)(tv & 0xFFFFFFFF);
   uuid_internal.time_mid = (uint16_t)((tv >> 32) & 0xFFFF);
   uuid_internal.time_hi_and_version = (uint16_t)((tv >> 48) | UUID_VERSION);
-  uuid_internal.clock_seq = time_seq_global;
+  uuid_internal.clock_seq = state.time_seq;
 
-  memcpy(uuid_internal.node, node_global, sizeof(node_global));
+  memcpy(uuid_internal.node, state.node, sizeof(state.node));
   memcpy(uuid, &uuid_internal, sizeof(uuid_internal));
 }
 
 
+namespace uuid
+{
+
+void generate_uuid(uuid_type &uuid)
+{
+  Thread_state &state = get_state();
+  unsigned long long tv
+    = next_time(state, my_getsystime() + UUID_TIME_OFFSET);
+  store_uuid(uuid, state, tv);
+}
+
+
+void generate_uuids(uuid_type *uuids, size_t count)
+{
+  if (!count)
+    return;
+
+  Thread_state &state = get_state();
+
+  /*
+    System time is read only once -- consecutive UUIDs get consecutive
+    time values, "borrowed" from the future as described in next_time().
+  */
+
+  unsigned long long now = my_getsystime() + UUID_TIME_OFFSET;
+
+  for (size_t i = 0; i < count; ++i)
+    store_uuid(uuids[i], state, next_time(state, now));
+}
+
+
+void to_hex(const uuid_type &uuid, char *buf)
+{
+  static const char digits[] = "0123456789ABCDEF";
+
+  for (size_t i = 0; i < sizeof(uuid_type); ++i)
+  {
+    buf[2 * i]     = digits[uuid[i] >> 4];
+    buf[2 * i + 1] = digits[uuid[i] & 0x0F];
+  }
+}
+
+
 void set_seed(uint16_t seed)
 {
-  Uuid_guard guard;
-  uuid_seed ^= seed;
-  generate_node();
+  std::lock_guard<std::mutex> guard(seed_lock);
+
+  uint32_t old_seed = seed_global.load(std::memory_order_relaxed);
+  uint16_t new_seed = (uint16_t)(old_seed ^ seed);
+
+  /* Generate random node part using the new seed. */
+
+  uint16_t rand_seed = new_seed;
+  uint16_t i = 0;
+  uint16_t rand_buf[3];
+
+  /* Run a few steps through the sequence */
+  i = rand_fibonacci(rand_seed) & 7;
+  while (i && rand_fibonacci(rand_seed)) --i;
+
+  for (i = 0; i < 3; i++)
+  {
+    rand_buf[i] = rand_fibonacci(rand_seed);
+  }
+
+  uint64_t node = 0;
+  memcpy(&node, rand_buf, 6);
+  node_global.store(node, std::memory_order_relaxed);
+
+  /*
+    Increase seed version so that threads re-initialize their state
+    (note: version 0 is reserved for not initialized seed).
+  */
+
+  uint32_t version = (old_seed >> 16) + 1;
+  if (!(version & 0xFFFF))
+    version = 1;
+
+  seed_global.store((version << 16) | new_seed, std::memory_order_release);
 }
 
 
@@ -352,4 +527,4 @@ void set_seed_from_time_pid()
 }
 
 
-}
\ No newline at end of file
+}
@@ -502,6 +502,13 @@ SSL_METHOD* SSLv2_client_method(void);   /* will never work, no v 2    */
 
 SSL_SESSION* SSL_get1_session(SSL* ssl);  /* what's ref count */
 
+/*
+  yaSSL extension: client side session resumption by session id, which
+  does not require keeping SSL_SESSION pointers owned by the session cache.
+*/
+const unsigned char* SSL_get_session_id(SSL*, unsigned int* len);
+int SSL_resume_session_id(SSL*, const unsigned char* id, unsigned int len);
+
 
 #define CRYPTO_free(x) free(x)
 #define ASN1_TIME ASN1_STRING
@@ -666,6 +666,7 @@ public:
     void set_random(const opaque*, ConnectionEnd);
     void set_sessionID(const opaque*);
     void set_session(SSL_SESSION*);
+    bool resume_session(const opaque*);
     void set_preMaster(const opaque*, uint);
     void set_masterSecret(const opaque*);
     void SetError(YasslError);
@@ -1432,6 +1432,31 @@ SSL_SESSION* SSL_get1_session(SSL* ssl)  /* what's ref count */
 }
 
 
+// id of the session established on this connection, if any
+const unsigned char* SSL_get_session_id(SSL* ssl, unsigned int* len)
+{
+    const Connection& conn = ssl->getSecurity().get_connection();
+
+    if (!conn.sessionID_Set_) {
+        if (len) *len = 0;
+        return 0;
+    }
+
+    if (len) *len = ID_LEN;
+    return conn.sessionID_;
+}
+
+
+// try to resume session with given id if it is still in the session cache
+int SSL_resume_session_id(SSL* ssl, const unsigned char* id, unsigned int len)
+{
+    if (!id || len != ID_LEN)
+        return SSL_FAILURE;
+
+    return ssl->resume_session(id) ? SSL_SUCCESS : SSL_FAILURE;
+}
+
+
 void GENERAL_NAMES_free(STACK_OF(GENERAL_NAME) *x)
 {
     // no extension names supported yet
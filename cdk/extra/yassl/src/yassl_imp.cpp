@@ -1578,6 +1578,9 @@ void ServerHello::Process(input_buffer& input, SSL& ssl)
         ssl.SetError(badVersion_error);
         return;
     }
+    // remember choosen suite so that it is stored with the session
+    ssl.useSecurity().use_parms().suite_[0] = cipher_suite_[0];
+    ssl.useSecurity().use_parms().suite_[1] = cipher_suite_[1];
     ssl.set_pending(cipher_suite_[1]);
     ssl.set_random(random_, server_end);
     if (id_len_)
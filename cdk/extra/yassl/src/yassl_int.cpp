@@ -1472,6 +1472,21 @@ void SSL::set_session(SSL_SESSION* s)
 }
 
 
+// resume session with given id, using a copy taken from the session cache
+bool SSL::resume_session(const opaque* id)
+{
+    if (getSecurity().GetContext()->GetSessionCacheOff())
+        return false;
+
+    if (!GetSessions().lookup(id, &secure_.use_resume()))
+        return false;
+
+    secure_.set_resuming(true);
+    crypto_.use_certManager().setPeerX509(secure_.use_resume().GetPeerX509());
+    return true;
+}
+
+
 const Crypto& SSL::getCrypto() const
 {
     return crypto_;
@@ -73,6 +73,43 @@ IMPL_TYPE(cdk::foundation::connection::TCPIP, connection_TCPIP_impl);
 IMPL_PLAIN(cdk::foundation::connection::TCPIP);
 
 
+/*
+  Implementation of Unix domain socket connection class.
+*/
+
+
+class connection_Unix_socket_impl
+  : public ::cdk::foundation::connection::TCPIP_base::Impl
+{
+  std::string m_path;
+
+public:
+
+  connection_Unix_socket_impl(const std::string &path)
+    : m_path(path)
+  {}
+
+  void do_connect();
+};
+
+
+void connection_Unix_socket_impl::do_connect()
+{
+  using namespace ::cdk::foundation::connection;
+
+  // do nothing if connection is already established
+  if (is_open())
+    return;
+
+  m_sock = detail::connect(m_path.c_str());
+}
+
+
+IMPL_TYPE(cdk::foundation::connection::Unix_socket,
+          connection_Unix_socket_impl);
+IMPL_PLAIN(cdk::foundation::connection::Unix_socket);
+
+
 namespace cdk {
 namespace foundation {
 namespace connection {
@@ -90,6 +127,17 @@ TCPIP_base::Impl& TCPIP::get_base_impl()
 }
 
 
+Unix_socket::Unix_socket(const std::string& path)
+  : opaque_impl<Unix_socket>(NULL, path)
+{}
+
+
+TCPIP_base::Impl& Unix_socket::get_base_impl()
+{
+  return get_impl();
+}
+
+
 void TCPIP_base::IO_op::do_cancel()
 {
   // if operation is completed - does nothing
@@ -98,10 +146,9 @@ void TCPIP_base::IO_op::do_cancel()
 }
 
 
-TCPIP::Read_op::Read_op(TCPIP &conn, const buffers &bufs, time_t deadline)
+TCPIP::Read_op::Read_op(TCPIP_base &conn, const buffers &bufs, time_t deadline)
   : IO_op(conn, bufs, deadline)
-  , m_currentBufferIdx(0)
-  , m_currentBufferOffset(0)
+  , m_bytesTransferred(0)
 {
   Impl &impl = conn.get_base_impl();
 
@@ -117,21 +164,13 @@ bool TCPIP::Read_op::do_cont()
 
   Impl& impl = m_conn.get_base_impl();
 
-  const bytes& buffer = m_bufs.get_buffer(m_currentBufferIdx);
-  byte* data =buffer.begin() + m_currentBufferOffset;
-  size_t buffer_size = buffer.size() - m_currentBufferOffset;
-
-  m_currentBufferOffset += detail::recv_some(impl.m_sock, data, buffer_size, 0);
+  m_bytesTransferred += detail::recv_some(impl.m_sock, m_bufs,
+                                          m_bytesTransferred, false);
 
-  if (m_currentBufferOffset == buffer.size())
+  if (m_bytesTransferred == m_bufs.length())
   {
-    ++m_currentBufferIdx;
-
-    if (m_currentBufferIdx == m_bufs.buf_count())
-    {
-      set_completed(m_bufs.length());
-      return true;
-    }
+    set_completed(m_bufs.length());
+    return true;
   }
 
   return false;
@@ -145,22 +184,14 @@ void TCPIP::Read_op::do_wait()
 
   Impl& impl = m_conn.get_base_impl();
 
-  for (unsigned int end = m_bufs.buf_count(); m_currentBufferIdx != end; ++m_currentBufferIdx)
-  {
-    const bytes& buffer = m_bufs.get_buffer(m_currentBufferIdx);
-    byte* data = buffer.begin() + m_currentBufferOffset;
-    size_t buffer_size = buffer.size() - m_currentBufferOffset;
-
-    detail::recv(impl.m_sock, data, buffer_size); // TODO: Implement operation deadline.
-
-    m_currentBufferOffset = 0;
-  }
+  detail::recv(impl.m_sock, m_bufs, m_bytesTransferred, m_deadline);
+  m_bytesTransferred = m_bufs.length();
 
   set_completed(m_bufs.length());
 }
 
 
-TCPIP::Read_some_op::Read_some_op(TCPIP &conn, const buffers &bufs, time_t deadline)
+TCPIP::Read_some_op::Read_some_op(TCPIP_base &conn, const buffers &bufs, time_t deadline)
   : IO_op(conn, bufs, deadline)
 {
   Impl &impl = conn.get_base_impl();
@@ -193,15 +224,14 @@ void TCPIP::Read_some_op::common_read(bool wait)
 
   const bytes& buffer = m_bufs.get_buffer(0);
 
-  // TODO: Add timeout support.
-  set_completed(detail::recv_some(impl.m_sock, buffer.begin(), buffer.size(), wait));
+  set_completed(detail::recv_some(impl.m_sock, buffer.begin(), buffer.size(),
+                                  wait, m_deadline));
 }
 
 
-TCPIP::Write_op::Write_op(TCPIP &conn, const buffers &bufs, time_t deadline)
+TCPIP::Write_op::Write_op(TCPIP_base &conn, const buffers &bufs, time_t deadline)
   : IO_op(conn, bufs, deadline)
-  , m_currentBufferIdx(0)
-  , m_currentBufferOffset(0)
+  , m_bytesTransferred(0)
 {
   Impl &impl = conn.get_base_impl();
 
@@ -217,21 +247,13 @@ bool TCPIP::Write_op::do_cont()
 
   Impl& impl = m_conn.get_base_impl();
 
-  const bytes& buffer = m_bufs.get_buffer(m_currentBufferIdx);
-  byte* data = buffer.begin() + m_currentBufferOffset;
-  size_t buffer_size = buffer.size() - m_currentBufferOffset;
-
-  m_currentBufferOffset += detail::send_some(impl.m_sock, data, buffer_size, 0);
+  m_bytesTransferred += detail::send_some(impl.m_sock, m_bufs,
+                                          m_bytesTransferred, false);
 
-  if (m_currentBufferOffset == buffer.size())
+  if (m_bytesTransferred == m_bufs.length())
   {
-    ++m_currentBufferIdx;
-
-    if (m_currentBufferIdx == m_bufs.buf_count())
-    {
-      set_completed(m_bufs.length());
-      return true;
-    }
+    set_completed(m_bufs.length());
+    return true;
   }
 
   return false;
@@ -245,22 +267,14 @@ void TCPIP::Write_op::do_wait()
 
   Impl& impl = m_conn.get_base_impl();
 
-  for (unsigned int end = m_bufs.buf_count(); m_currentBufferIdx != end; ++m_currentBufferIdx)
-  {
-    const bytes& buffer = m_bufs.get_buffer(m_currentBufferIdx);
-    byte* data = buffer.begin() + m_currentBufferOffset;
-    size_t buffer_size = buffer.size() - m_currentBufferOffset;
-
-    detail::send(impl.m_sock, data, buffer_size); // TODO: Implement operation deadline.
-
-    m_currentBufferOffset = 0;
-  }
+  detail::send(impl.m_sock, m_bufs, m_bytesTransferred, m_deadline);
+  m_bytesTransferred = m_bufs.length();
 
   set_completed(m_bufs.length());
 }
 
 
-TCPIP::Write_some_op::Write_some_op(TCPIP &conn, const buffers &bufs, time_t deadline)
+TCPIP::Write_some_op::Write_some_op(TCPIP_base &conn, const buffers &bufs, time_t deadline)
   : IO_op(conn, bufs, deadline)
 {
   Impl &impl = conn.get_base_impl();
@@ -293,8 +307,8 @@ void TCPIP::Write_some_op::common_write(bool wait)
 
   const bytes& buffer = m_bufs.get_buffer(0);
 
-  // TODO: Add timeout support.
-  set_completed(detail::send_some(impl.m_sock, buffer.begin(), buffer.size(), wait));
+  set_completed(detail::send_some(impl.m_sock, buffer.begin(), buffer.size(),
+                                  wait, m_deadline));
 }
 
 
@@ -113,7 +113,7 @@ public:
   {
     if (!is_open())
       return false;
-    return detail::select_one(m_sock, detail::SELECT_MODE_WRITE, false) > 0;
+    return detail::poll_one(m_sock, detail::POLL_MODE_WRITE, false) > 0;
   }
 
   virtual ~Impl()
@@ -32,6 +32,10 @@ POP_SYS_WARNINGS
 #include "socket_detail.h"
 #include "connection_tcpip_base.h"
 
+#include <map>
+#include <mutex>
+#include <cstring>
+
 
 static const char* tls_ciphers_list="DHE-RSA-AES256-SHA:DHE-RSA-AES128-SHA:"
                                     "AES128-RMD:DES-CBC3-RMD:DHE-RSA-AES256-RMD:"
@@ -58,6 +62,206 @@ static void throw_yassl_error()
 }
 
 
+/*
+  Process-wide cache of TLS contexts and client sessions.
+
+  TLS contexts are shared by all connections which use the same TLS options,
+  so that CA certificates are loaded only once. Contexts are never released
+  before process exit. Note that changes to CA files are not seen after
+  a context has been created.
+
+  For each server end-point (the peer address of the connection) and TLS
+  context we remember the id of the session established by the last full
+  handshake. New connections to the same end-point try to resume this
+  session, which requires an abbreviated handshake only.
+
+  Only session ids are stored here. Sessions themselves are owned by the
+  global yaSSL session cache which removes them when they expire - in that
+  case resumption is not attempted and a full handshake is done instead.
+*/
+
+class TLS_cache
+{
+  std::mutex m_lock;
+  std::map<std::string, yaSSL::SSL_CTX*> m_ctx;
+  std::map<std::string, std::string>     m_sess;
+
+public:
+
+  ~TLS_cache()
+  {
+    for (auto &entry : m_ctx)
+      yaSSL::SSL_CTX_free(entry.second);
+  }
+
+  yaSSL::SSL_CTX* get_ctx(const cdk::foundation::connection::TLS::Options&,
+                          std::string &key);
+
+  bool resume_session(const std::string &key, yaSSL::SSL *tls);
+  void store_session(const std::string &key, yaSSL::SSL *tls);
+  void drop_session(const std::string &key);
+};
+
+
+static TLS_cache& get_tls_cache()
+{
+  static TLS_cache cache;
+  return cache;
+}
+
+
+/*
+  Return TLS context for given options, creating it if it is not yet in
+  the cache. On return `key` identifies the context.
+*/
+
+yaSSL::SSL_CTX*
+TLS_cache::get_ctx(const cdk::foundation::connection::TLS::Options &options,
+                   std::string &key)
+{
+  key = options.get_ca();
+  key.push_back('\0');
+  key.append(options.get_ca_path());
+
+  std::lock_guard<std::mutex> guard(m_lock);
+
+  auto it = m_ctx.find(key);
+  if (it != m_ctx.end())
+    return it->second;
+
+  yaSSL::SSL_METHOD* method = yaSSL::TLSv1_1_client_method();
+
+  if (!method)
+    throw_yassl_error();
+
+  yaSSL::SSL_CTX *ctx = SSL_CTX_new(method);
+  if (!ctx)
+    throw_yassl_error();
+
+  try
+  {
+    std::string cipher_list;
+    cipher_list.append(tls_cipher_blocked);
+    cipher_list.append(tls_ciphers_list);
+
+    SSL_CTX_set_cipher_list(ctx, cipher_list.c_str());
+    SSL_CTX_set_session_cache_mode(ctx, yaSSL::SSL_SESS_CACHE_CLIENT);
+
+    if (!options.get_ca().empty() ||
+        !options.get_ca_path().empty())
+    {
+      SSL_CTX_set_verify(ctx, yaSSL::SSL_VERIFY_PEER , NULL);
+
+      int errNr = SSL_CTX_load_verify_locations(
+                    ctx,
+                    options.get_ca().c_str(),
+                    options.get_ca_path().empty()
+                    ? NULL : options.get_ca_path().c_str());
+
+      switch(errNr)
+      {
+        case yaSSL::SSL_BAD_FILE:
+          throw_yassl_error_msg("error opening ca file");
+        case yaSSL::SSL_BAD_PATH:
+          throw_yassl_error_msg("bad ca_path");
+        case yaSSL::SSL_BAD_STAT:
+          throw_yassl_error_msg("bad file permissions inside ca_path");
+        default:
+          break;
+      }
+
+    }
+    else
+    {
+      SSL_CTX_set_verify(ctx, yaSSL::SSL_VERIFY_NONE, 0);
+    }
+  }
+  catch (...)
+  {
+    yaSSL::SSL_CTX_free(ctx);
+    throw;
+  }
+
+  m_ctx[key] = ctx;
+  return ctx;
+}
+
+
+/*
+  Request resumption of the session stored under given key for the given
+  (not yet connected) TLS connection. Returns false if there is no such
+  session or if it is no longer in the yaSSL session cache.
+*/
+
+bool TLS_cache::resume_session(const std::string &key, yaSSL::SSL *tls)
+{
+  std::string id;
+
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto it = m_sess.find(key);
+    if (it == m_sess.end())
+      return false;
+
+    id = it->second;
+  }
+
+  if (yaSSL::SSL_SUCCESS == yaSSL::SSL_resume_session_id(tls,
+        (const unsigned char*)id.data(), (unsigned)id.size()))
+    return true;
+
+  drop_session(key);
+  return false;
+}
+
+
+/*
+  Remember id of the session established by a full handshake on the given
+  connection.
+*/
+
+void TLS_cache::store_session(const std::string &key, yaSSL::SSL *tls)
+{
+  unsigned int len = 0;
+  const unsigned char *id = yaSSL::SSL_get_session_id(tls, &len);
+
+  if (!id || 0 == len)
+    return;
+
+  std::lock_guard<std::mutex> guard(m_lock);
+  m_sess[key].assign((const char*)id, len);
+}
+
+
+void TLS_cache::drop_session(const std::string &key)
+{
+  std::lock_guard<std::mutex> guard(m_lock);
+  m_sess.erase(key);
+}
+
+
+/*
+  Return address of the peer of the given socket as a binary string, or
+  empty string if it can not be determined.
+*/
+
+static std::string peer_address(unsigned int fd)
+{
+  using cdk::foundation::connection::detail::Socket;
+
+  sockaddr_storage addr;
+  socklen_t len = sizeof(addr);
+
+  memset(&addr, 0, sizeof(addr));
+
+  if (0 != ::getpeername(static_cast<Socket>(fd), (sockaddr*)&addr, &len))
+    return std::string();
+
+  return std::string((const char*)&addr, static_cast<size_t>(len));
+}
+
+
 /*
   Implementation of TLS connection class.
 */
@@ -83,17 +287,15 @@ public:
       yaSSL::SSL_free(m_tls);
     }
 
-    if (m_tls_ctx)
-      yaSSL::SSL_CTX_free(m_tls_ctx);
-
     delete m_tcpip;
   }
 
   void do_connect();
+  void handshake();
 
   cdk::foundation::connection::TCPIP_base* m_tcpip;
   yaSSL::SSL* m_tls;
-  yaSSL::SSL_CTX* m_tls_ctx;
+  yaSSL::SSL_CTX* m_tls_ctx;  // shared context owned by TLS_cache
   cdk::foundation::connection::TLS::Options m_options;
 };
 
@@ -109,52 +311,30 @@ void connection_TLS_impl::do_connect()
     return;
   }
 
-  try
-  {
-    yaSSL::SSL_METHOD* method = yaSSL::TLSv1_1_client_method();
-
-    if (!method)
-      throw_yassl_error();
-
-    m_tls_ctx = SSL_CTX_new(method);
-    if (!m_tls_ctx)
-      throw_yassl_error();
-
-
-    std::string cipher_list;
-    cipher_list.append(tls_cipher_blocked);
-    cipher_list.append(tls_ciphers_list);
-
-    SSL_CTX_set_cipher_list(m_tls_ctx, cipher_list.c_str());
+  handshake();
+}
 
-    if (!m_options.get_ca().empty() ||
-        !m_options.get_ca_path().empty())
-    {
-      SSL_CTX_set_verify(m_tls_ctx, yaSSL::SSL_VERIFY_PEER , NULL);
 
-      int errNr = SSL_CTX_load_verify_locations(
-                    m_tls_ctx,
-                    m_options.get_ca().c_str(),
-                    m_options.get_ca_path().empty()
-                    ? NULL : m_options.get_ca_path().c_str());
+/*
+  Perform TLS handshake over connected m_tcpip connection, trying to resume
+  a cached session if there is one.
+
+  If a handshake which tried to resume a session fails, the session is
+  forgotten and the error is thrown. The connection can not be simply
+  re-tried here because the upper protocol layer might have exchanged
+  messages over the plain connection before TLS was started. It is up to
+  the caller to open a new connection which will then do a full handshake.
+*/
 
-      switch(errNr)
-      {
-        case yaSSL::SSL_BAD_FILE:
-          throw_yassl_error_msg("error opening ca file");
-        case yaSSL::SSL_BAD_PATH:
-          throw_yassl_error_msg("bad ca_path");
-        case yaSSL::SSL_BAD_STAT:
-          throw_yassl_error_msg("bad file permissions inside ca_path");
-        default:
-          break;
-      }
+void connection_TLS_impl::handshake()
+{
+  TLS_cache &cache = get_tls_cache();
+  std::string sess_key;
+  bool resuming = false;
 
-    }
-    else
-    {
-      SSL_CTX_set_verify(m_tls_ctx, yaSSL::SSL_VERIFY_NONE, 0);
-    }
+  try
+  {
+    m_tls_ctx = cache.get_ctx(m_options, sess_key);
 
     m_tls = yaSSL::SSL_new(m_tls_ctx);
     if (!m_tls)
@@ -166,9 +346,26 @@ void connection_TLS_impl::do_connect()
 
     yaSSL::SSL_set_fd(m_tls, static_cast<yaSSL::YASSL_SOCKET_T>(fd));
 
+    /*
+      Sessions are cached per TLS context and peer address. If the peer
+      address is not known, session is not cached.
+    */
+
+    std::string peer = peer_address(fd);
+
+    if (peer.empty())
+      sess_key.clear();
+    else
+      sess_key.append(peer);
+
+    if (!sess_key.empty())
+      resuming = cache.resume_session(sess_key, m_tls);
+
     if(yaSSL::SSL_connect(m_tls) != yaSSL::SSL_SUCCESS)
       throw_yassl_error();
 
+    if (!sess_key.empty() && !yaSSL::SSL_session_reused(m_tls))
+      cache.store_session(sess_key, m_tls);
   }
   catch (...)
   {
@@ -179,11 +376,12 @@ void connection_TLS_impl::do_connect()
       m_tls = NULL;
     }
 
-    if (m_tls_ctx)
-    {
-      yaSSL::SSL_CTX_free(m_tls_ctx);
-      m_tls_ctx = NULL;
-    }
+    m_tls_ctx = NULL;
+
+    // Do not try to resume the same session again.
+
+    if (resuming)
+      cache.drop_session(sess_key);
 
     throw;
   }
@@ -30,6 +30,8 @@ PUSH_SYS_WARNINGS
 #include "../extra/yassl/include/openssl/ssl.h"
 #endif // WITH_SSL_YASSL
 #include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <limits>
 #ifndef _WIN32
 #include <arpa/inet.h>
@@ -274,6 +276,19 @@ static void throw_socket_error()
 }
 
 
+/**
+  Checks if last socket operation failed only because it would block.
+*/
+static bool would_block()
+{
+#ifdef _WIN32
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+
 /**
   Checks socket's state for errors. If an error is encountered, the appropriate
   exception is thrown.
@@ -530,9 +545,9 @@ Socket connect(const char *host_name, unsigned short port)
         if (connect_result == SOCKET_ERROR && errno == EINPROGRESS)
       #endif
         {
-          int select_result = select_one(socket, SELECT_MODE_WRITE, true);
+          int poll_result = poll_one(socket, POLL_MODE_WRITE, true);
 
-          if (select_result < 0)
+          if (poll_result < 0)
             throw_socket_error();
           else
             check_socket_error(socket);
@@ -560,6 +575,68 @@ Socket connect(const char *host_name, unsigned short port)
 
 DIAGNOSTIC_POP
 
+
+Socket connect(const char *path)
+{
+#ifdef _WIN32
+
+  (void)path;
+  throw_error("Unix domain sockets are not supported on this platform.");
+
+#else
+
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+
+  if (!path || !*path)
+    throw_error("Empty socket path.");
+
+  if (strlen(path) >= sizeof(addr.sun_path))
+    throw_error(std::string("Socket path is too long: ") + path);
+
+  strcpy(addr.sun_path, path);
+
+  addrinfo hints = {};
+  hints.ai_family = AF_UNIX;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = 0;
+
+  Socket socket = detail::socket(true, &hints);
+
+  try
+  {
+    if (0 != ::connect(socket, (sockaddr*)&addr, sizeof(addr)))
+    {
+      /*
+        Note: Unlike for TCP sockets, EAGAIN returned by non-blocking
+        connect() on a Unix domain socket means that the backlog of the
+        listening socket is full. The connection was not started then
+        and there is nothing to wait for.
+      */
+
+      if (errno != EINPROGRESS)
+        throw_socket_error();
+
+      int poll_result = poll_one(socket, POLL_MODE_WRITE, true);
+
+      if (poll_result < 0)
+        throw_socket_error();
+      else
+        check_socket_error(socket);
+    }
+  }
+  catch (...)
+  {
+    close(socket);
+    throw;
+  }
+
+  return socket;
+
+#endif
+}
+
+
 Socket listen_and_accept(unsigned short port)
 {
   Socket client = NULL_SOCKET;
@@ -578,9 +655,9 @@ Socket listen_and_accept(unsigned short port)
       throw_socket_error();
     }
 
-    int select_result = select_one(acceptor, SELECT_MODE_READ, true);
+    int poll_result = poll_one(acceptor, POLL_MODE_READ, true);
 
-    if (select_result > 0)
+    if (poll_result > 0)
     {
       sockaddr_in cli_addr = {};
       socklen_t cli_addr_length = sizeof(cli_addr);
@@ -589,8 +666,20 @@ Socket listen_and_accept(unsigned short port)
 
       if (client == NULL_SOCKET)
         throw_socket_error();
+
+      // Accepted socket does not inherit non-blocking mode on all platforms.
+
+      try
+      {
+        set_nonblocking(client, true);
+      }
+      catch (...)
+      {
+        close(client);
+        throw;
+      }
     }
-    else if (select_result == 0)
+    else if (poll_result == 0)
     {
       check_socket_error(acceptor);
     }
@@ -611,36 +700,47 @@ Socket listen_and_accept(unsigned short port)
 }
 
 
-int select_one(Socket socket, Select_mode mode, bool wait)
+int poll_one(Socket socket, Poll_mode mode, bool wait, time_t deadline)
 {
-  timeval zero_timeout = {};
+  // Timeout for poll() in milliseconds, -1 means infinite wait.
 
-DIAGNOSTIC_PUSH
+  int timeout = 0;
 
-#ifdef _WIN32
-  // 4548 = expression has no effect
-  // This warning is generated by FD_SET
-  DISABLE_WARNING(4548)
-#endif
+  if (wait)
+  {
+    timeout = -1;
 
-  fd_set socket_set;
-  FD_ZERO(&socket_set);
-  FD_SET(socket, &socket_set);
+    if (deadline)
+    {
+      time_t now = ::time(NULL);
 
-  fd_set except_set;
-  FD_ZERO(&except_set);
-  FD_SET(socket, &except_set);
+      if (now >= deadline)
+        throw connection::Error_timeout();
 
-DIAGNOSTIC_POP
+      time_t left = deadline - now;
 
-  int result = ::select(FD_SETSIZE,
-    mode == SELECT_MODE_READ ? &socket_set : NULL,
-    mode == SELECT_MODE_WRITE ? &socket_set : NULL,
-    &except_set, wait ? NULL : &zero_timeout);
+      timeout = left < std::numeric_limits<int>::max() / 1000
+                ? static_cast<int>(left * 1000)
+                : std::numeric_limits<int>::max();
+    }
+  }
+
+  pollfd fds = {};
+  fds.fd = socket;
+  fds.events = (mode == POLL_MODE_READ ? POLLIN : POLLOUT);
+
+#ifdef _WIN32
+  int result = ::WSAPoll(&fds, 1, timeout);
+#else
+  int result = ::poll(&fds, 1, timeout);
+#endif
 
-  if (result > 0 && FD_ISSET(socket, &except_set))
+  if (result > 0 && (fds.revents & (POLLERR | POLLNVAL)))
     check_socket_error(socket);
 
+  if (result == 0 && timeout > 0)
+    throw connection::Error_timeout();
+
   return result;
 }
 
@@ -662,92 +762,172 @@ size_t bytes_available(Socket socket)
 }
 
 
-void recv(Socket socket, byte *buffer, size_t buffer_size)
-{
-  // TODO: Investigate if more efficient implementation is possible with ::recv() and MSG_WAITALL flag.
-
-  if (buffer_size == 0)
-    return;
+/*
+  Vectored I/O
+  ============
 
-  size_t bytes_received = 0;
+  All data transfers are done with vectored socket calls (sendmsg()/recvmsg()
+  or WSASend()/WSARecv() on Windows) which can transfer data from/to several
+  buffers in a single system call. Io_vec is the platform specific buffer
+  descriptor used by these calls.
+*/
 
-  while (bytes_received != buffer_size)
-    bytes_received += recv_some(socket, buffer + bytes_received, buffer_size - bytes_received, true);
-}
+#ifdef _WIN32
 
+typedef WSABUF Io_vec;
 
-void send(Socket socket, const byte *buffer, size_t buffer_size)
+static void set_io_vec(Io_vec &vec, byte *data, size_t len)
 {
-  if (buffer_size == 0)
-    return;
+  vec.buf = reinterpret_cast<CHAR*>(data);
+  vec.len = static_cast<ULONG>(len);
+}
+
+#else
 
-  size_t bytes_sent = 0;
+typedef iovec Io_vec;
 
-  while (bytes_sent != buffer_size)
-    bytes_sent += send_some(socket, buffer + bytes_sent, buffer_size - bytes_sent, true);
+static void set_io_vec(Io_vec &vec, byte *data, size_t len)
+{
+  vec.iov_base = data;
+  vec.iov_len = len;
 }
 
+#endif
 
-size_t recv_some(Socket socket, byte *buffer, size_t buffer_size, bool wait)
-{
-  if (buffer_size == 0)
-    return 0;
 
-  /*
-    TODO: buffer size checks - throw error if passed buffer is bigger than
-    some reasonable limit.
-  */
-  assert(buffer_size > 0);
-  assert(buffer_size < (size_t)std::numeric_limits<int>::max());
+/// Maximal number of buffers transferred in a single system call.
+const unsigned max_io_vec = 16;
+
 
-  size_t bytes_received = 0;
+/**
+  Fill Io_vec array with descriptors of the parts of given buffers that
+  start at given offset. Empty buffers are skipped. Returns number of
+  descriptors stored in the array (at most max_io_vec).
+*/
 
-  int select_result = select_one(socket, SELECT_MODE_READ, wait);
+static unsigned fill_io_vec(Io_vec *vec, const buffers &bufs, size_t offset)
+{
+  unsigned count = 0;
 
-  if (select_result > 0)
+  for (unsigned pos = 0; pos < bufs.buf_count() && count < max_io_vec; ++pos)
   {
-    int recv_result = ::recv(socket, reinterpret_cast<char *>(buffer),
-                             static_cast<int>(buffer_size), 0);
+    bytes buf = bufs.get_buffer(pos);
 
-    if (recv_result == 0)
+    if (offset >= buf.size())
     {
-      throw connection::Error_eos();
+      offset -= buf.size();
+      continue;
     }
-    else if (recv_result == SOCKET_ERROR)
-    {
+
+    set_io_vec(vec[count++], buf.begin() + offset, buf.size() - offset);
+    offset = 0;
+  }
+
+  return count;
+}
+
+
+/*
+  Send/receive data described by Io_vec array. Returns the number of bytes
+  transferred or SOCKET_ERROR.
+*/
+
+static int send_vec(Socket socket, Io_vec *vec, unsigned count)
+{
 #ifdef _WIN32
-      if (WSAGetLastError() == WSAEWOULDBLOCK)
+  DWORD sent = 0;
+  if (::WSASend(socket, vec, count, &sent, 0, NULL, NULL) == SOCKET_ERROR)
+    return SOCKET_ERROR;
+  return static_cast<int>(sent);
 #else
-      if (errno == EAGAIN || errno == EWOULDBLOCK)
+  msghdr msg = {};
+  msg.msg_iov = vec;
+  msg.msg_iovlen = count;
+  return static_cast<int>(::sendmsg(socket, &msg, 0));
 #endif
-      {
-        bytes_received = 0;
-      }
-      else
-      {
-        throw_socket_error();
-      }
-    }
-    else
-    {
-      assert(recv_result > 0);
-      bytes_received = static_cast<size_t>(recv_result);
-    }
-  }
-  else if (select_result == 0)
-  {
+}
+
+
+static int recv_vec(Socket socket, Io_vec *vec, unsigned count)
+{
+#ifdef _WIN32
+  DWORD received = 0;
+  DWORD flags = 0;
+  if (::WSARecv(socket, vec, count, &received, &flags, NULL, NULL)
+      == SOCKET_ERROR)
+    return SOCKET_ERROR;
+  return static_cast<int>(received);
+#else
+  msghdr msg = {};
+  msg.msg_iov = vec;
+  msg.msg_iovlen = count;
+  return static_cast<int>(::recvmsg(socket, &msg, 0));
+#endif
+}
+
+
+/*
+  Non-blocking operations first check socket's state with poll_one() so
+  that they do not block even if the socket is in blocking mode. Blocking
+  operations call send/recv right away and wait for the socket only if it
+  is not ready yet - in the common case data is already there and the extra
+  system call is avoided.
+*/
+
+static size_t io_some(Socket socket, Poll_mode mode, Io_vec *vec,
+                      unsigned count, bool wait, time_t deadline)
+{
+  if (0 == count)
     return 0;
+
+  if (!wait)
+  {
+    int poll_result = poll_one(socket, mode, false);
+
+    if (poll_result < 0)
+      throw_socket_error();
+
+    if (poll_result == 0)
+      return 0;
   }
-  else
+
+  for (;;)
   {
-    throw_socket_error();
+    int result = (POLL_MODE_READ == mode ? recv_vec(socket, vec, count)
+                                         : send_vec(socket, vec, count));
+
+    if (result == 0 && POLL_MODE_READ == mode)
+      throw connection::Error_eos();
+
+    if (result >= 0)
+      return static_cast<size_t>(result);
+
+    if (!would_block())
+      throw_socket_error();
+
+    if (!wait)
+      return 0;
+
+    if (poll_one(socket, mode, true, deadline) < 0)
+      throw_socket_error();
   }
+}
+
 
-  return bytes_received;
+void recv(Socket socket, byte *buffer, size_t buffer_size, time_t deadline)
+{
+  recv(socket, buffers(buffer, buffer_size), 0, deadline);
+}
+
+
+void send(Socket socket, const byte *buffer, size_t buffer_size, time_t deadline)
+{
+  send(socket, buffers(const_cast<byte*>(buffer), buffer_size), 0, deadline);
 }
 
 
-size_t send_some(Socket socket, const byte *buffer, size_t buffer_size, bool wait)
+size_t recv_some(Socket socket, byte *buffer, size_t buffer_size, bool wait,
+                 time_t deadline)
 {
   if (buffer_size == 0)
     return 0;
@@ -759,46 +939,68 @@ size_t send_some(Socket socket, const byte *buffer, size_t buffer_size, bool wai
   assert(buffer_size > 0);
   assert(buffer_size < (size_t)std::numeric_limits<int>::max());
 
-  size_t bytes_sent = 0;
+  Io_vec vec;
+  set_io_vec(vec, buffer, buffer_size);
 
-  int select_result = select_one(socket, SELECT_MODE_WRITE, wait);
+  return io_some(socket, POLL_MODE_READ, &vec, 1, wait, deadline);
+}
 
-  if (select_result > 0)
-  {
-    int send_result = ::send(socket, reinterpret_cast<const char *>(buffer),
-                             static_cast<int>(buffer_size), 0);
 
-    if (send_result == SOCKET_ERROR)
-    {
-#ifdef _WIN32
-      if (WSAGetLastError() == WSAEWOULDBLOCK)
-#else
-      if (errno == EAGAIN || errno == EWOULDBLOCK)
-#endif
-      {
-        bytes_sent = 0;
-      }
-      else
-      {
-        throw_socket_error();
-      }
-    }
-    else
-    {
-      assert(send_result >= 0);
-      bytes_sent = static_cast<size_t>(send_result);
-    }
-  }
-  else if (select_result == 0)
-  {
+size_t send_some(Socket socket, const byte *buffer, size_t buffer_size,
+                 bool wait, time_t deadline)
+{
+  if (buffer_size == 0)
     return 0;
-  }
-  else
-  {
-    throw_socket_error();
-  }
 
-  return bytes_sent;
+  /*
+    TODO: buffer size checks - throw error if passed buffer is bigger than
+    some reasonable limit.
+  */
+  assert(buffer_size > 0);
+  assert(buffer_size < (size_t)std::numeric_limits<int>::max());
+
+  Io_vec vec;
+  set_io_vec(vec, const_cast<byte*>(buffer), buffer_size);
+
+  return io_some(socket, POLL_MODE_WRITE, &vec, 1, wait, deadline);
+}
+
+
+void recv(Socket socket, const buffers &bufs, size_t offset, time_t deadline)
+{
+  size_t length = bufs.length();
+
+  while (offset < length)
+    offset += recv_some(socket, bufs, offset, true, deadline);
+}
+
+
+void send(Socket socket, const buffers &bufs, size_t offset, time_t deadline)
+{
+  size_t length = bufs.length();
+
+  while (offset < length)
+    offset += send_some(socket, bufs, offset, true, deadline);
+}
+
+
+size_t recv_some(Socket socket, const buffers &bufs, size_t offset, bool wait,
+                 time_t deadline)
+{
+  Io_vec vec[max_io_vec];
+  unsigned count = fill_io_vec(vec, bufs, offset);
+
+  return io_some(socket, POLL_MODE_READ, vec, count, wait, deadline);
+}
+
+
+size_t send_some(Socket socket, const buffers &bufs, size_t offset, bool wait,
+                 time_t deadline)
+{
+  Io_vec vec[max_io_vec];
+  unsigned count = fill_io_vec(vec, bufs, offset);
+
+  return io_some(socket, POLL_MODE_WRITE, vec, count, wait, deadline);
 }
 
 
@@ -39,10 +39,12 @@ PUSH_SYS_WARNINGS
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
-#include <sys/select.h>
+#include <sys/uio.h>
+#include <poll.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <netinet/in.h>
+#include <sys/un.h>
 #include <fcntl.h>
 #include <netdb.h>
 
@@ -80,10 +82,10 @@ enum Shutdown_mode
 };
 
 
-enum Select_mode
+enum Poll_mode
 {
-  SELECT_MODE_READ,
-  SELECT_MODE_WRITE
+  POLL_MODE_READ,
+  POLL_MODE_WRITE
 };
 
 
@@ -228,6 +230,29 @@ addrinfo* addrinfo_from_string(const char* host_name, unsigned short port);
 Socket connect(const char *host, unsigned short port);
 
 
+/**
+  Create and connect Unix domain socket.
+
+  Creates and connects a socket to a local server listening on a Unix
+  domain socket.
+
+  @param[in] path
+    Path of the socket file.
+
+  @return
+    Connected socket.
+
+  @throw cdk::foundation::Error
+    Connection failed or Unix domain sockets are not supported on this
+    platform.
+
+  @note
+    This function always blocks.
+*/
+
+Socket connect(const char *path);
+
+
 /**
   Listen for incoming connections and accept them.
 
@@ -255,6 +280,8 @@ Socket listen_and_accept(unsigned short port);
   Test socket's I/O state.
 
   Tests if data can be read from or written to a socket without blocking.
+  The test is done with `poll()` (`WSAPoll()` on Windows) so, unlike with
+  `select()`, there is no limit on the value of socket descriptor.
 
   @param[in] socket
     Socket to be tested.
@@ -262,15 +289,19 @@ Socket listen_and_accept(unsigned short port);
     I/O mode.
   @param[in] wait
     If `true`, function will block. Otherwise, it will return immediately.
+  @param[in] deadline
+    If not 0, the time after which waiting is aborted.
 
   @return
-    Same as POSIX `select` function.
+    Same as POSIX `poll` function.
 
+  @throw cdk::foundation::connection::Error_timeout
+    Socket did not become ready before the deadline.
   @throw cdk::foundation::Error
     If after testing socket is in an erroneous state, function throws.
 */
 
-int select_one(Socket socket, Select_mode mode, bool wait);
+int poll_one(Socket socket, Poll_mode mode, bool wait, time_t deadline = 0);
 
 
 /**
@@ -304,9 +335,13 @@ size_t bytes_available(Socket socket);
   @param[in] buffer_size
     Number of bytes that will be read from a socket. May not be larger than
     the size of `buffer`.
+  @param[in] deadline
+    If not 0, the time after which the operation is aborted.
 
   @throw cdk::foundation::connection::Error_eos
     End-of-stream encountered.
+  @throw cdk::foundation::connection::Error_timeout
+    Not all bytes were received before the deadline.
   @throw cdk::foundation::Error
     Socket read failed.
 
@@ -314,7 +349,7 @@ size_t bytes_available(Socket socket);
     This function always blocks.
 */
 
-void recv(Socket socket, byte *buffer, size_t buffer_size);
+void recv(Socket socket, byte *buffer, size_t buffer_size, time_t deadline = 0);
 
 
 /**
@@ -330,7 +365,11 @@ void recv(Socket socket, byte *buffer, size_t buffer_size);
   @param[in] buffer_size
     Number of bytes that will be sent to a socket. May not be larger than
     the size of `buffer`.
+  @param[in] deadline
+    If not 0, the time after which the operation is aborted.
 
+  @throw cdk::foundation::connection::Error_timeout
+    Not all bytes were sent before the deadline.
   @throw cdk::foundation::Error
     Socket write failed.
 
@@ -338,7 +377,7 @@ void recv(Socket socket, byte *buffer, size_t buffer_size);
     This function always blocks.
 */
 
-void send(Socket socket, const byte *buffer, size_t buffer_size);
+void send(Socket socket, const byte *buffer, size_t buffer_size, time_t deadline = 0);
 
 
 /**
@@ -354,18 +393,28 @@ void send(Socket socket, const byte *buffer, size_t buffer_size);
     Maximum number of bytes that will be read from a socket. May not be larger
     than the size of `buffer`.
   @param[in] wait
-    If `true`, operation will block. Otherwise, data is immediately available.
+    If `true`, operation will block until some data is available. Otherwise,
+    only data which is immediately available is read.
+  @param[in] deadline
+    If not 0, the time after which blocking operation is aborted.
 
   @return
     The number of bytes read from a socket.
 
   @throw cdk::foundation::connection::Error_eos
     End-of-stream encountered.
+  @throw cdk::foundation::connection::Error_timeout
+    No data was received before the deadline.
   @throw cdk::foundation::Error
     Socket read failed.
+
+  @note
+    Blocking operation first tries to read data and waits for the socket
+    to become readable only if no data is available yet.
 */
 
-size_t recv_some(Socket socket, byte *buffer, size_t buffer_size, bool wait);
+size_t recv_some(Socket socket, byte *buffer, size_t buffer_size, bool wait,
+                 time_t deadline = 0);
 
 
 /**
@@ -381,16 +430,113 @@ size_t recv_some(Socket socket, byte *buffer, size_t buffer_size, bool wait);
     Maximum number of bytes that will be sent to a socket. May not be larger
     than the size of `buffer`.
   @param[in] wait
-    If `true`, operation will block. Otherwise, it will return immediately.
+    If `true`, operation will block until some data can be sent. Otherwise,
+    it will return immediately.
+  @param[in] deadline
+    If not 0, the time after which blocking operation is aborted.
 
   @return
     The number of bytes sent to a socket.
 
+  @throw cdk::foundation::connection::Error_timeout
+    No data could be sent before the deadline.
+  @throw cdk::foundation::Error
+    Socket write failed.
+
+  @note
+    Blocking operation first tries to send data and waits for the socket
+    to become writable only if its send buffer is full.
+*/
+
+size_t send_some(Socket socket, const byte *buffer, size_t buffer_size,
+                 bool wait, time_t deadline = 0);
+
+
+/**
+  Receives data from a socket into a set of buffers.
+
+  Receives data into the given buffers, starting at given offset (counted
+  from the beginning of the first buffer), until all buffers are filled.
+  Data is received into several buffers at once using vectored I/O.
+
+  @param[in] socket
+    Socket used for reading.
+  @param[out] bufs
+    Data buffers.
+  @param[in] offset
+    Number of bytes at the beginning of the buffers that are already filled.
+  @param[in] deadline
+    If not 0, the time after which the operation is aborted.
+
+  @throw cdk::foundation::connection::Error_eos
+    End-of-stream encountered.
+  @throw cdk::foundation::connection::Error_timeout
+    Not all bytes were received before the deadline.
+  @throw cdk::foundation::Error
+    Socket read failed.
+
+  @note
+    This function always blocks.
+*/
+
+void recv(Socket socket, const buffers &bufs, size_t offset,
+          time_t deadline = 0);
+
+
+/**
+  Sends data from a set of buffers to a socket.
+
+  Sends contents of the given buffers, starting at given offset, until all
+  bytes are sent. Several buffers are sent at once using vectored I/O.
+
+  @param[in] socket
+    Socket used for sending.
+  @param[in] bufs
+    Data buffers.
+  @param[in] offset
+    Number of bytes at the beginning of the buffers that were already sent.
+  @param[in] deadline
+    If not 0, the time after which the operation is aborted.
+
+  @throw cdk::foundation::connection::Error_timeout
+    Not all bytes were sent before the deadline.
   @throw cdk::foundation::Error
     Socket write failed.
+
+  @note
+    This function always blocks.
+*/
+
+void send(Socket socket, const buffers &bufs, size_t offset,
+          time_t deadline = 0);
+
+
+/**
+  Receives some data from a socket into a set of buffers.
+
+  Like `recv_some()` for single buffer, but can fill several of the given
+  buffers, starting at given offset, in a single system call.
+
+  @return
+    The number of bytes read from a socket.
+*/
+
+size_t recv_some(Socket socket, const buffers &bufs, size_t offset, bool wait,
+                 time_t deadline = 0);
+
+
+/**
+  Sends some data from a set of buffers to a socket.
+
+  Like `send_some()` for single buffer, but can send data from several of
+  the given buffers, starting at given offset, in a single system call.
+
+  @return
+    The number of bytes sent to a socket.
 */
 
-size_t send_some(Socket socket, const byte *buffer, size_t buffer_size, bool wait);
+size_t send_some(Socket socket, const buffers &bufs, size_t offset, bool wait,
+                 time_t deadline = 0);
 
 
 }}}} // cdk::foundation::connection::detail
@@ -57,7 +57,14 @@ string::operator std::string() const
 #ifndef HAVE_CODECVT_UTF8
 
 /*
-  Implementation of UTF-8 codecvt facet using boost::locale
+  Implementation of UTF-8 codecvt facet.
+
+  Conversion is done by hand-written code which has a fast path for
+  runs of ASCII characters: these are converted 16 characters at a time
+  (using SSE2 instructions, if available). Other characters are
+  converted one code point at a time, rejecting overlong encodings,
+  surrogates and values above U+10FFFF. If wide characters are 16-bit,
+  characters outside BMP are represented as surrogate pairs.
 
   TODO: This implementation of std::codecvt interface is incomplete
   and will probably not work as a locale facet when used with C++
@@ -65,16 +72,231 @@ string::operator std::string() const
   implemented. See: http://en.cppreference.com/w/cpp/locale/codecvt
 */
 
-PUSH_BOOST_WARNINGS
-#include <boost/locale/utf.hpp>
-POP_BOOST_WARNINGS
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF8_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace cdk {
 namespace foundation {
 
-using namespace boost::locale;
+namespace {
+
+typedef uint32_t code_point;
+
+const code_point invalid_cp = 0xFFFFFFFFU;
+const code_point incomplete_cp = 0xFFFFFFFEU;
+
+inline
+bool is_valid_cp(code_point c)
+{
+  return c <= 0x10FFFF && (c < 0xD800 || c > 0xDFFF);
+}
+
+
+/*
+  Convert a run of ASCII characters starting at `from`, stopping at the
+  first non-ASCII character or when either the input or the output
+  buffer is exhausted.
+*/
+
+inline
+void ascii_in(const char *&from, const char *from_end,
+              char_t *&to, char_t *to_end)
+{
+#ifdef UTF8_USE_SSE2
+
+  const __m128i zero = _mm_setzero_si128();
+
+  while (from_end - from >= 16 && to_end - to >= 16)
+  {
+    __m128i chunk = _mm_loadu_si128((const __m128i*)from);
+
+    if (0 != _mm_movemask_epi8(chunk))
+      break;
+
+    __m128i lo = _mm_unpacklo_epi8(chunk, zero);
+    __m128i hi = _mm_unpackhi_epi8(chunk, zero);
+
+    if (4 == sizeof(char_t))
+    {
+      _mm_storeu_si128((__m128i*)to, _mm_unpacklo_epi16(lo, zero));
+      _mm_storeu_si128((__m128i*)(to + 4), _mm_unpackhi_epi16(lo, zero));
+      _mm_storeu_si128((__m128i*)(to + 8), _mm_unpacklo_epi16(hi, zero));
+      _mm_storeu_si128((__m128i*)(to + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+    else
+    {
+      _mm_storeu_si128((__m128i*)to, lo);
+      _mm_storeu_si128((__m128i*)(to + 8), hi);
+    }
+
+    from += 16;
+    to += 16;
+  }
+
+#endif
+
+  while (from < from_end && to < to_end && 0 == (*from & 0x80))
+    *to++ = (char_t)*from++;
+}
+
+
+inline
+void ascii_out(const char_t *&from, const char_t *from_end,
+               char *&to, char *to_end)
+{
+#ifdef UTF8_USE_SSE2
+
+  if (4 == sizeof(char_t))
+  {
+    const __m128i high = _mm_set1_epi32(~0x7F);
+
+    while (from_end - from >= 16 && to_end - to >= 16)
+    {
+      const __m128i *src = (const __m128i*)from;
+      __m128i a = _mm_loadu_si128(src);
+      __m128i b = _mm_loadu_si128(src + 1);
+      __m128i c = _mm_loadu_si128(src + 2);
+      __m128i d = _mm_loadu_si128(src + 3);
+
+      __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+      any = _mm_and_si128(any, high);
+      if (0xFFFF != _mm_movemask_epi8(
+                      _mm_cmpeq_epi32(any, _mm_setzero_si128())))
+        break;
+
+      __m128i ab = _mm_packs_epi32(a, b);
+      __m128i cd = _mm_packs_epi32(c, d);
+      _mm_storeu_si128((__m128i*)to, _mm_packus_epi16(ab, cd));
+
+      from += 16;
+      to += 16;
+    }
+  }
+  else
+  {
+    const __m128i high = _mm_set1_epi16(~0x7F);
+
+    while (from_end - from >= 16 && to_end - to >= 16)
+    {
+      const __m128i *src = (const __m128i*)from;
+      __m128i a = _mm_loadu_si128(src);
+      __m128i b = _mm_loadu_si128(src + 1);
+
+      __m128i any = _mm_and_si128(_mm_or_si128(a, b), high);
+      if (0xFFFF != _mm_movemask_epi8(
+                      _mm_cmpeq_epi16(any, _mm_setzero_si128())))
+        break;
 
-typedef utf::utf_traits<char> utf8;
+      _mm_storeu_si128((__m128i*)to, _mm_packus_epi16(a, b));
+
+      from += 16;
+      to += 16;
+    }
+  }
+
+#endif
+
+  while (from < from_end && to < to_end && 0 == ((code_point)*from & ~0x7FU))
+    *to++ = (char)*from++;
+}
+
+
+/*
+  Decode single UTF-8 encoded character. Returns invalid_cp if the
+  sequence is not valid UTF-8 and incomplete_cp if input ends in the
+  middle of the sequence. On success `from` is moved past the sequence.
+*/
+
+inline
+code_point decode_utf8(const char *&from, const char *from_end)
+{
+  const unsigned char *pos = (const unsigned char*)from;
+  unsigned char lead = *pos;
+  unsigned len;
+  code_point c;
+
+  if (lead < 0x80)
+  {
+    from++;
+    return lead;
+  }
+  else if (lead < 0xC2)
+    return invalid_cp;  // continuation byte or overlong 2-byte sequence
+  else if (lead < 0xE0)
+  {
+    len = 2;
+    c = lead & 0x1F;
+  }
+  else if (lead < 0xF0)
+  {
+    len = 3;
+    c = lead & 0x0F;
+  }
+  else if (lead < 0xF5)
+  {
+    len = 4;
+    c = lead & 0x07;
+  }
+  else
+    return invalid_cp;
+
+  for (unsigned i = 1; i < len; ++i)
+  {
+    if (pos + i >= (const unsigned char*)from_end)
+      return incomplete_cp;
+    if (0x80 != (pos[i] & 0xC0))
+      return invalid_cp;
+    c = (c << 6) | (pos[i] & 0x3F);
+  }
+
+  // Reject overlong encodings, surrogates and too large values.
+
+  if ((3 == len && c < 0x800) || (4 == len && c < 0x10000)
+      || !is_valid_cp(c))
+    return invalid_cp;
+
+  from += len;
+  return c;
+}
+
+
+inline
+unsigned utf8_width(code_point c)
+{
+  return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+}
+
+
+inline
+char* encode_utf8(code_point c, char *to)
+{
+  switch (utf8_width(c))
+  {
+  case 1:
+    *to++ = (char)c;
+    break;
+  case 2:
+    *to++ = (char)(0xC0 | (c >> 6));
+    *to++ = (char)(0x80 | (c & 0x3F));
+    break;
+  case 3:
+    *to++ = (char)(0xE0 | (c >> 12));
+    *to++ = (char)(0x80 | ((c >> 6) & 0x3F));
+    *to++ = (char)(0x80 | (c & 0x3F));
+    break;
+  default:
+    *to++ = (char)(0xF0 | (c >> 18));
+    *to++ = (char)(0x80 | ((c >> 12) & 0x3F));
+    *to++ = (char)(0x80 | ((c >> 6) & 0x3F));
+    *to++ = (char)(0x80 | (c & 0x3F));
+    break;
+  }
+  return to;
+}
+
+}  // anonymous namespace
 
 
 // see: http://en.cppreference.com/w/cpp/locale/codecvt/out
@@ -93,13 +315,31 @@ codecvt_utf8::do_out(state_type& state,
 
   while (from_next < from_end)
   {
-    utf::code_point c = *from_next;
-    if (!utf::is_valid_codepoint(c))
+    ascii_out(from_next, from_end, to_next, to_end);
+
+    if (from_next >= from_end)
+      break;
+
+    const intern_type *next = from_next + 1;
+    code_point c = (code_point)*from_next;
+
+    if (2 == sizeof(intern_type) && c >= 0xD800 && c < 0xDC00)
+    {
+      if (next >= from_end)
+        return partial;
+      code_point low = (code_point)*next++;
+      if (low < 0xDC00 || low > 0xDFFF)
+        return error;
+      c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+    }
+    else if (!is_valid_cp(c))
       return error;
-    if (to_next + utf8::width(c) > to_end)
+
+    if (to_next + utf8_width(c) > to_end)
       return partial;
-    to_next = utf8::encode(c, to_next);
-    from_next++;
+
+    to_next = encode_utf8(c, to_next);
+    from_next = next;
   }
 
   return ok;
@@ -122,15 +362,34 @@ codecvt_utf8::do_in(state_type& state,
 
   while (from_next < from_end)
   {
-    utf::code_point c = utf8::decode(from_next, from_end);
-    if (c == utf::illegal)
+    ascii_in(from_next, from_end, to_next, to_end);
+
+    if (from_next >= from_end)
+      break;
+
+    if (to_next >= to_end)
+      return partial;
+
+    const extern_type *next = from_next;
+    code_point c = decode_utf8(next, from_end);
+
+    if (invalid_cp == c)
       return error;
-    if (c == utf::incomplete || to_next >= to_end)
+    if (incomplete_cp == c)
       return partial;
-    // TODO: compiler warns about possible loss of data when
-    // converting output of utf8::decode (code_point) to intern_type.
-    *to_next = (intern_type)c;
-    to_next++;
+
+    if (2 == sizeof(intern_type) && c >= 0x10000)
+    {
+      if (to_next + 2 > to_end)
+        return partial;
+      c -= 0x10000;
+      *to_next++ = (intern_type)(0xD800 + (c >> 10));
+      *to_next++ = (intern_type)(0xDC00 + (c & 0x3FF));
+    }
+    else
+      *to_next++ = (intern_type)c;
+
+    from_next = next;
   }
 
   return ok;
@@ -24,6 +24,7 @@
 
 #include "test.h"
 #include <mysql/cdk/foundation/codec.h>
+#include <mysql/cdk/foundation/varint.h>
 
 using namespace ::std;
 using namespace ::cdk::foundation;
@@ -47,7 +48,9 @@ using namespace ::cdk::foundation;
   X (ukrainian, L"\u042F \u043C\u043E\u0436\u0443 \u0457\u0441\u0442\u0438 \u0441\u043A\u043B\u043E, \u0456 \u0432\u043E\u043D\u043E \u043C\u0435\u043D\u0456 \u043D\u0435 \u0437\u0430\u0448\u043A\u043E\u0434\u0438\u0442\u044C", \
      "\xD0\xAF\x20\xD0\xBC\xD0\xBE\xD0\xB6\xD1\x83\x20\xD1\x97\xD1\x81\xD1\x82\xD0\xB8\x20\xD1\x81\xD0\xBA\xD0\xBB\xD0\xBE\x2C\x20\xD1\x96\x20\xD0\xB2\xD0\xBE\xD0\xBD\xD0\xBE\x20\xD0\xBC\xD0\xB5\xD0\xBD\xD1\x96\x20\xD0\xBD\xD0\xB5\x20\xD0\xB7\xD0\xB0\xD1\x88\xD0\xBA\xD0\xBE\xD0\xB4\xD0\xB8\xD1\x82\xD1\x8C") \
   X (portuguese, L"Posso comer vidro, n\u00E3o me faz mal", \
-     "\x50\x6F\x73\x73\x6F\x20\x63\x6F\x6D\x65\x72\x20\x76\x69\x64\x72\x6F\x2C\x20\x6E\xC3\xA3\x6F\x20\x6D\x65\x20\x66\x61\x7A\x20\x6D\x61\x6C")
+     "\x50\x6F\x73\x73\x6F\x20\x63\x6F\x6D\x65\x72\x20\x76\x69\x64\x72\x6F\x2C\x20\x6E\xC3\xA3\x6F\x20\x6D\x65\x20\x66\x61\x7A\x20\x6D\x61\x6C") \
+  X (non_bmp, L"Long run of ASCII characters, then \U0001F600 and \u20AC", \
+     "Long run of ASCII characters, then \xF0\x9F\x98\x80 and \xE2\x82\xAC")
 
 TEST(Foundation, string)
 {
@@ -95,6 +98,26 @@ TEST(Foundation, string)
     EXPECT_EQ(narrow, (std::string)wide);
     EXPECT_EQ(wide, string(narrow));
   }
+
+  // Invalid UTF-8 sequences should be rejected.
+
+  const char *invalid[] =
+  {
+    "\x80",                  // continuation byte
+    "abc\xC0\xAF",           // overlong encoding of '/'
+    "\xE0\x80\xAF",          // overlong 3-byte encoding
+    "\xED\xA0\x80",          // surrogate
+    "\xF4\x90\x80\x80",      // above U+10FFFF
+    "\xC3\x28",              // bad continuation byte
+    "0123456789abcdef\xE2\x82", // incomplete sequence
+  };
+
+  for (unsigned i=0; i < sizeof(invalid)/sizeof(char*); ++i)
+  {
+    string out;
+    EXPECT_THROW(codec.from_bytes(bytes(invalid[i]), out), Error)
+      << "sample " << i;
+  }
 }
 
 
@@ -399,3 +422,109 @@ TEST(Foundation, number)
   EXPECT_EQ(2U,howmuch);
 
 }
+
+
+/*
+  Varint Decoding
+  ===============
+*/
+
+// Reference encoder used to prepare test data.
+
+static size_t varint_encode(uint64_t val, byte *buf)
+{
+  size_t len = 0;
+  for (; val >= 0x80; val >>= 7)
+    buf[len++] = (byte)(0x80 | (val & 0x7F));
+  buf[len++] = (byte)val;
+  return len;
+}
+
+
+TEST(Foundation, varint)
+{
+  using namespace cdk::foundation::varint;
+
+  const uint64_t samples[] =
+  {
+    0, 1, 127, 128, 300, 16383, 16384,
+    (1ULL << 49) - 1, (1ULL << 56) - 1, 1ULL << 56,
+    1ULL << 63, 0xFFFFFFFFFFFFFFFFULL
+  };
+
+  const size_t count = sizeof(samples)/sizeof(uint64_t);
+
+  /*
+    Each sample is encoded at the beginning of a buffer with some extra
+    bytes after it (to test the fast path) and also in a buffer of exact
+    length (to test decoding near the end of the data).
+  */
+
+  byte buf[count][max_length + 8];
+  bytes fields[count];
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    memset(buf[i], 0xFF, sizeof(buf[i]));
+    size_t len = varint_encode(samples[i], buf[i]);
+    fields[i] = bytes(buf[i], len);
+
+    uint64_t val;
+
+    EXPECT_EQ(len, decode(buf[i], buf[i] + sizeof(buf[i]), val));
+    EXPECT_EQ(samples[i], val);
+
+    EXPECT_EQ(len, decode(fields[i], val));
+    EXPECT_EQ(samples[i], val);
+
+    // Truncated varint
+
+    if (len > 1)
+    {
+      EXPECT_EQ(0U, decode(buf[i], buf[i] + len - 1, val));
+    }
+  }
+
+  // Batch decoding
+
+  uint64_t vals[count];
+  EXPECT_EQ(count, decode(fields, count, vals));
+  for (size_t i = 0; i < count; ++i)
+    EXPECT_EQ(samples[i], vals[i]);
+
+  // Too long varint
+
+  byte bad[16];
+  memset(bad, 0x80, sizeof(bad));
+  uint64_t val;
+  EXPECT_EQ(0U, decode(bad, bad + sizeof(bad), val));
+
+  fields[3] = bytes(bad, sizeof(bad));
+  EXPECT_EQ(3U, decode(fields, count, vals));
+
+  // Zig-zag encoding
+
+  const int64_t signed_samples[] =
+  {
+    0, -1, 1, -64, 64, 12345678, -12345678,
+    std::numeric_limits<int64_t>::max(),
+    std::numeric_limits<int64_t>::min()
+  };
+
+  const size_t signed_count = sizeof(signed_samples)/sizeof(int64_t);
+  int64_t svals[signed_count];
+
+  for (size_t i = 0; i < signed_count; ++i)
+  {
+    uint64_t enc = zigzag_encode(signed_samples[i]);
+    EXPECT_EQ(signed_samples[i], zigzag_decode(enc));
+    fields[i] = bytes(buf[i], varint_encode(enc, buf[i]));
+  }
+
+  EXPECT_EQ(1U, zigzag_encode(-1));
+  EXPECT_EQ(2U, zigzag_encode(1));
+
+  EXPECT_EQ(signed_count, decode_signed(fields, signed_count, svals));
+  for (size_t i = 0; i < signed_count; ++i)
+    EXPECT_EQ(signed_samples[i], svals[i]);
+}
@@ -37,6 +37,7 @@
 #include <process_launcher.h>
 #include <exception.h>
 #include <iostream>
+#include <ctime>
 #include <mysql/cdk/foundation/connection_tcpip.h>
 #include <mysql/cdk/foundation/error.h>
 
@@ -217,6 +218,108 @@ TEST_F(Foundation_connection_tcpip, IPv4_connection)
 }
 
 
+/*
+  Test that sends a message composed of several buffers and reads server's
+  reply into several buffers.
+
+  Note: Test server should be started before running this test.
+*/
+
+
+TEST_F(Foundation_connection_tcpip, multi_buffer)
+{
+  using cdk::foundation::byte;
+  using connection::TCPIP;
+
+  TCPIP conn("localhost", PORT);
+
+  try
+  {
+    conn.connect();
+  }
+  catch (Error& e)
+  {
+    FAIL() << "Connection error: " << e << endl;
+  }
+
+  // Test server echoes the message, including the terminating null byte.
+
+  byte hello[] = "Hello ";
+  byte world[] = "World!";
+
+  buffers out_rest(world, sizeof(world));
+  buffers out(bytes(hello, sizeof(hello) - 1), out_rest);
+
+  TCPIP::Write_op write_op(conn, out);
+  write_op.wait();
+
+  EXPECT_EQ(out.length(), write_op.get_result());
+
+  char in1[4];
+  char in2[10];
+
+  buffers in_rest((byte*)in2, sizeof(in2));
+  buffers in(bytes((byte*)in1, sizeof(in1)), in_rest);
+
+  TCPIP::Read_op read_op(conn, in);
+  read_op.wait();
+
+  EXPECT_EQ(in.length(), read_op.get_result());
+  EXPECT_EQ(std::string("Hell"), std::string(in1, sizeof(in1)));
+  EXPECT_EQ(std::string("o World!"), std::string(in2));
+
+  cout << "Done!" << endl;
+}
+
+
+/*
+  Test that blocking read operation created with a deadline is aborted
+  when no data arrives before the deadline.
+
+  Note: Test server should be started before running this test.
+*/
+
+
+TEST_F(Foundation_connection_tcpip, deadline)
+{
+  using cdk::foundation::byte;
+  using connection::TCPIP;
+
+  byte buf_raw[16];
+  buffers bufs(buf_raw, sizeof(buf_raw));
+
+  TCPIP conn("localhost", PORT);
+
+  try
+  {
+    conn.connect();
+  }
+  catch (Error& e)
+  {
+    FAIL() << "Connection error: " << e << endl;
+  }
+
+  // Test server waits for our message, so nothing can be read here.
+
+  try
+  {
+    TCPIP::Read_op read_op(conn, bufs, time(NULL) + 1);
+    read_op.wait();
+    FAIL() << "Read operation should time out" << endl;
+  }
+  catch (connection::Error_timeout &e)
+  {
+    cout << "Expected exception: " << e << endl;
+  }
+  catch (Error &e)
+  {
+    FAIL() << "Received error does not match expected error: " << e << endl;
+  }
+
+  cout << "Done!" << endl;
+}
+
+
 /*
   IPv6 connection test.
 
@@ -484,3 +587,62 @@ TEST_F(Foundation_connection_tcpip, closed)
 }
 
 
+
+
+#ifndef _WIN32
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <memory>
+
+/*
+  Connecting to a Unix domain socket whose listen backlog is full should
+  fail immediately instead of waiting for the connection to complete.
+*/
+
+TEST(Foundation_unix_socket, backlog_full)
+{
+  using connection::Unix_socket;
+
+  std::string path = "/tmp/cdk_foundation_test.";
+  path.append(std::to_string(getpid()));
+
+  int acceptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_LE(0, acceptor);
+
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path.c_str());
+  unlink(path.c_str());
+
+  ASSERT_EQ(0, ::bind(acceptor, (sockaddr*)&addr, sizeof(addr)));
+  ASSERT_EQ(0, ::listen(acceptor, 1));
+
+  // Connections are never accepted, so the backlog fills up.
+
+  std::vector<std::unique_ptr<Unix_socket>> conns;
+  bool failed = false;
+
+  for (unsigned i = 0; i < 16 && !failed; ++i)
+  {
+    conns.emplace_back(new Unix_socket(path));
+
+    try {
+      conns.back()->connect();
+    }
+    catch (const Error &e)
+    {
+      cout << "Connection #" << i << " failed: " << e << endl;
+      failed = true;
+    }
+  }
+
+  EXPECT_TRUE(failed);
+
+  conns.clear();
+  ::close(acceptor);
+  unlink(path.c_str());
+}
+
+#endif
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This code is licensed under the terms of the GPLv2
+ * <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+ * MySQL Connectors. There are special exceptions to the terms and
+ * conditions of the GPLv2 as it is applied to this software, see the
+ * FLOSS License Exception
+ * <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+
+/**
+  Unit tests for sdk::foundation::connection::TLS class: TLS session
+  resumption.
+
+  Tests run a simple TLS server (implemented with yaSSL directly) in
+  a separate thread, using self-signed test certificate from certs/
+  directory.
+*/
+
+#include "test.h"
+#include <mysql/cdk/foundation/common.h>
+#include <mysql/cdk/foundation/connection_tcpip.h>
+#include <mysql/cdk/foundation/error.h>
+
+#ifdef WITH_SSL
+
+#include <mysql/cdk/foundation/connection_yassl.h>
+PUSH_SYS_WARNINGS
+#include "../../extra/yassl/include/openssl/ssl.h"
+#include <signal.h>
+POP_SYS_WARNINGS
+#include "../socket_detail.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <ctime>
+
+using namespace ::std;
+using namespace cdk::foundation;
+
+namespace detail = cdk::foundation::connection::detail;
+
+
+/*
+  TLS server which accepts given number of connections on a port. For each
+  connection one of the actions is performed:
+
+  HANDSHAKE - TLS handshake, echo of a single byte and waiting for
+              the client to close the connection,
+  DROP      - connection is closed immediately, before TLS handshake.
+
+  For each connection server records whether the TLS session was resumed
+  (RESUMED), a full handshake was done (FULL) or connection was dropped
+  (DROPPED).
+*/
+
+class Tls_server
+{
+public:
+
+  enum Action { HANDSHAKE, DROP };
+  enum Result { FULL, RESUMED, DROPPED, FAILED };
+
+  Tls_server(unsigned short port, const vector<Action> &plan,
+             bool session_cache = true)
+    : m_plan(plan)
+  {
+#ifndef _WIN32
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    m_ctx = yaSSL::SSL_CTX_new(yaSSL::TLSv1_1_server_method());
+
+    if (!session_cache)
+      yaSSL::SSL_CTX_set_session_cache_mode(m_ctx, yaSSL::SSL_SESS_CACHE_OFF);
+
+    if (yaSSL::SSL_SUCCESS != yaSSL::SSL_CTX_use_certificate_file(m_ctx,
+          TLS_CERTS_DIR "/server-cert.pem", yaSSL::SSL_FILETYPE_PEM)
+        || yaSSL::SSL_SUCCESS != yaSSL::SSL_CTX_use_PrivateKey_file(m_ctx,
+          TLS_CERTS_DIR "/server-key.pem", yaSSL::SSL_FILETYPE_PEM))
+      throw_error("Could not load server certificate");
+
+    m_sock = detail::socket(false);
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+
+    if (0 != ::bind(m_sock, (sockaddr*)&addr, sizeof(addr))
+        || 0 != ::listen(m_sock, 5))
+    {
+      detail::close(m_sock);
+      throw_error("Could not start test TLS server");
+    }
+
+    m_thread = std::thread([this]() { run(); });
+  }
+
+  ~Tls_server()
+  {
+    if (m_thread.joinable())
+      m_thread.join();
+    detail::close(m_sock);
+    yaSSL::SSL_CTX_free(m_ctx);
+  }
+
+  const vector<Result>& results()
+  {
+    m_thread.join();
+    return m_results;
+  }
+
+private:
+
+  yaSSL::SSL_CTX  *m_ctx;
+  detail::Socket   m_sock;
+  vector<Action>   m_plan;
+  vector<Result>   m_results;
+  std::thread      m_thread;
+
+  void run()
+  {
+    for (Action action : m_plan)
+    {
+      // Do not wait forever if client does not connect.
+
+      try {
+        if (0 >= detail::poll_one(m_sock, detail::POLL_MODE_READ, true,
+                                  time(NULL) + 10))
+          return;
+      }
+      catch (...)
+      {
+        return;
+      }
+
+      detail::Socket client = ::accept(m_sock, NULL, NULL);
+
+      if (detail::NULL_SOCKET == client)
+      {
+        m_results.push_back(FAILED);
+        continue;
+      }
+
+      if (DROP == action)
+      {
+        detail::close(client);
+        m_results.push_back(DROPPED);
+        continue;
+      }
+
+      yaSSL::SSL *tls = yaSSL::SSL_new(m_ctx);
+      yaSSL::SSL_set_fd(tls, static_cast<yaSSL::YASSL_SOCKET_T>(client));
+
+      if (yaSSL::SSL_SUCCESS != yaSSL::SSL_accept(tls))
+        m_results.push_back(FAILED);
+      else
+      {
+        m_results.push_back(yaSSL::SSL_session_reused(tls) ? RESUMED : FULL);
+
+        // Echo one byte and wait until client closes connection.
+
+        char buf;
+        if (1 == yaSSL::SSL_read(tls, &buf, 1))
+          yaSSL::SSL_write(tls, &buf, 1);
+        while (0 < yaSSL::SSL_read(tls, &buf, 1));
+      }
+
+      yaSSL::SSL_free(tls);
+      detail::close(client);
+    }
+  }
+};
+
+
+/*
+  Open TLS connection to the test server, send one byte and read it back.
+*/
+
+static void tls_connect(unsigned short port)
+{
+  using connection::TCPIP;
+  using connection::TLS;
+
+  TCPIP *tcpip = new TCPIP("127.0.0.1", port);
+
+  try {
+    tcpip->connect();
+  }
+  catch (...)
+  {
+    delete tcpip;
+    throw;
+  }
+
+  TLS tls(tcpip, TLS::Options());
+  tls.connect();
+
+  byte data = 'x';
+
+  TLS::Write_op write(tls, buffers(&data, 1));
+  write.wait();
+
+  data = 0;
+
+  TLS::Read_op read(tls, buffers(&data, 1));
+  read.wait();
+
+  EXPECT_EQ('x', data);
+}
+
+
+/*
+  Second connection to the same server resumes TLS session established
+  by the first one.
+*/
+
+TEST(Foundation_tls, resume)
+{
+  const unsigned short port = 9877;
+
+  Tls_server server(port,
+                    { Tls_server::HANDSHAKE, Tls_server::HANDSHAKE,
+                      Tls_server::HANDSHAKE });
+
+  try {
+    tls_connect(port);
+    tls_connect(port);
+    tls_connect(port);
+  }
+  catch (Error &e)
+  {
+    FAIL() << "Connection error: " << e;
+  }
+
+  vector<Tls_server::Result> res = server.results();
+
+  ASSERT_EQ(3U, res.size());
+  EXPECT_EQ(Tls_server::FULL, res[0]);
+  EXPECT_EQ(Tls_server::RESUMED, res[1]);
+  EXPECT_EQ(Tls_server::RESUMED, res[2]);
+}
+
+
+/*
+  If handshake resuming a cached session fails, the error is reported and
+  the session is forgotten. Next connection does a full handshake and the
+  new session is cached.
+*/
+
+TEST(Foundation_tls, resume_failed)
+{
+  const unsigned short port = 9878;
+
+  Tls_server server(port,
+                    { Tls_server::HANDSHAKE, Tls_server::DROP,
+                      Tls_server::HANDSHAKE, Tls_server::HANDSHAKE });
+
+  try {
+    tls_connect(port);
+  }
+  catch (Error &e)
+  {
+    FAIL() << "Connection error: " << e;
+  }
+
+  EXPECT_THROW(tls_connect(port), Error);
+
+  try {
+    tls_connect(port);
+    tls_connect(port);
+  }
+  catch (Error &e)
+  {
+    FAIL() << "Connection error: " << e;
+  }
+
+  vector<Tls_server::Result> res = server.results();
+
+  ASSERT_EQ(4U, res.size());
+  EXPECT_EQ(Tls_server::FULL, res[0]);
+  EXPECT_EQ(Tls_server::DROPPED, res[1]);
+  EXPECT_EQ(Tls_server::FULL, res[2]);
+  EXPECT_EQ(Tls_server::RESUMED, res[3]);
+}
+
+
+/*
+  If server does not know the cached session, a full handshake is done.
+*/
+
+TEST(Foundation_tls, resume_unknown)
+{
+  const unsigned short port = 9879;
+
+  Tls_server server(port,
+                    { Tls_server::HANDSHAKE, Tls_server::HANDSHAKE },
+                    false);
+
+  try {
+    tls_connect(port);
+    tls_connect(port);
+  }
+  catch (Error &e)
+  {
+    FAIL() << "Connection error: " << e;
+  }
+
+  vector<Tls_server::Result> res = server.results();
+
+  ASSERT_EQ(2U, res.size());
+  EXPECT_EQ(Tls_server::FULL, res[0]);
+  EXPECT_EQ(Tls_server::FULL, res[1]);
+}
+
+#endif
@@ -250,6 +250,79 @@ public:
 // TODO: Cover all supported types
 
 
+/*
+  Decoded values
+  ==============
+  Types used to represent DECIMAL and temporal values decoded by
+  the codecs below.
+*/
+
+/*
+  Fixed-point decimal number equal to m_val * 10^(-m_scale).
+*/
+
+struct Decimal
+{
+  int64_t  m_val;
+  unsigned m_scale;
+
+  Decimal() : m_val(0), m_scale(0) {}
+
+  operator double() const;
+};
+
+
+/*
+  DATETIME or TIMESTAMP value in broken-down form. Time part is 0 if
+  it was not present in the encoding (DATE columns).
+*/
+
+struct Datetime
+{
+  unsigned m_year;
+  unsigned m_month;
+  unsigned m_day;
+  unsigned m_hour;
+  unsigned m_minute;
+  unsigned m_second;
+  unsigned m_usec;
+
+  Datetime()
+    : m_year(0), m_month(0), m_day(0)
+    , m_hour(0), m_minute(0), m_second(0), m_usec(0)
+  {}
+
+  /*
+    Number of seconds since 1970-01-01 00:00:00, assuming that the
+    value is in UTC (fractional part is ignored).
+  */
+
+  int64_t epoch() const;
+};
+
+
+/*
+  TIME value, which can be negative and can have more than 24 hours.
+*/
+
+struct Time
+{
+  bool     m_negative;
+  unsigned m_hours;
+  unsigned m_minutes;
+  unsigned m_seconds;
+  unsigned m_usec;
+
+  Time()
+    : m_negative(false), m_hours(0), m_minutes(0), m_seconds(0), m_usec(0)
+  {}
+
+  // Total number of microseconds, negative for negative values.
+
+  int64_t usec() const;
+};
+
+
 /*
   Codecs
   ======
@@ -323,6 +396,9 @@ class Codec<TYPE_INTEGER>
   template <typename T>
   size_t internal_from_bytes(bytes buf, T &val);
 
+  template <typename T>
+  void internal_from_bytes(const bytes*, size_t, T*);
+
   template <typename T>
   size_t internal_to_bytes(T val, bytes buf);
 
@@ -339,6 +415,15 @@ public:
   virtual size_t from_bytes(bytes buf, uint32_t &val);
   virtual size_t from_bytes(bytes buf, uint64_t &val);
 
+  /*
+    Decode a column of `count` integer fields into `vals` array, which
+    must have room for `count` values. Throws error if any of the fields
+    can not be decoded or its value does not fit in the target type.
+  */
+
+  void from_bytes(const bytes *fields, size_t count, int64_t *vals);
+  void from_bytes(const bytes *fields, size_t count, uint64_t *vals);
+
   virtual size_t to_bytes(int8_t val, bytes buf);
   virtual size_t to_bytes(int16_t val, bytes buf);
   virtual size_t to_bytes(int32_t val, bytes buf);
@@ -364,8 +449,19 @@ public:
 
   virtual ~Codec() {}
 
+  /*
+    Note: DECIMAL values can be decoded into float or double, possibly
+    loosing precision, or into Decimal without loss of precision
+    (but throwing error if the value does not fit in it).
+  */
+
   virtual size_t from_bytes(bytes buf, float &val);
   virtual size_t from_bytes(bytes buf, double &val);
+  size_t from_bytes(bytes buf, Decimal &val);
+
+  // Decode a column of `count` DECIMAL fields into `vals` array.
+
+  void from_bytes(const bytes *fields, size_t count, Decimal *vals);
 
   virtual size_t to_bytes(float val, bytes buf);
   virtual size_t to_bytes(double val, bytes buf);
@@ -373,6 +469,30 @@ public:
 };
 
 
+/*
+  Codec for temporal values. Values of TIME columns are decoded into
+  Time, other values into Datetime. Attempt to decode a value into
+  the wrong type throws error.
+*/
+
+template <>
+class Codec<TYPE_DATETIME>
+  : Codec_base<TYPE_DATETIME>
+{
+public:
+
+  Codec(const Format_info &fi) : Codec_base<TYPE_DATETIME>(fi) {}
+
+  size_t from_bytes(bytes buf, Datetime &val);
+  size_t from_bytes(bytes buf, Time &val);
+
+  // Decode a column of `count` fields into `vals` array.
+
+  void from_bytes(const bytes *fields, size_t count, Datetime *vals);
+  void from_bytes(const bytes *fields, size_t count, Time *vals);
+};
+
+
 template <>
 class Codec<TYPE_DOCUMENT>
   : Codec_base<TYPE_DOCUMENT>
@@ -165,6 +165,34 @@ private:
 
 };
 
+
+/*
+ * A Unix_socket data source represents a local MySQL server accessible
+ * via Unix domain socket at given path. It accepts the same options as
+ * TCPIP data source.
+ */
+
+class Unix_socket
+{
+protected:
+  std::string m_path;
+
+public:
+
+  typedef TCPIP::Options Options;
+
+  Unix_socket(const std::string &_path)
+  : m_path(_path)
+  {
+    if (_path.empty())
+      throw_error("invalid empty socket path");
+  }
+
+  virtual ~Unix_socket() {}
+
+  virtual const std::string& path() const { return m_path; }
+};
+
 } // mysqlx
 
 namespace mysql {
@@ -195,6 +223,7 @@ public:
 //TCPIP defaults to mysqlx::TCPIP
 namespace ds {
   typedef mysqlx::TCPIP TCPIP;
+  typedef mysqlx::Unix_socket Unix_socket;
   typedef mysql::TCPIP TCPIP_old;
 }
 
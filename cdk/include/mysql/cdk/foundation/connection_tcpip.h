@@ -37,6 +37,7 @@ namespace connection {
 
 
 class TCPIP;
+class Unix_socket;
 class TLS;
 
 
@@ -129,6 +130,7 @@ protected:
 
   friend class IO_op;
   friend class TCPIP;
+  friend class Unix_socket;
   friend class TLS;
 };
 
@@ -151,6 +153,33 @@ private:
 };
 
 
+/*
+  Connection to a local server over Unix domain socket at given path.
+
+  It is a stream of the same kind as TCPIP and it re-uses TCPIP i/o
+  operations - only the way of establishing the connection differs.
+  Not supported on Windows, where connect() throws error.
+*/
+
+class Unix_socket
+  : public TCPIP_base
+  , opaque_impl<Unix_socket>
+{
+public:
+
+  typedef TCPIP::Read_op        Read_op;
+  typedef TCPIP::Read_some_op   Read_some_op;
+  typedef TCPIP::Write_op       Write_op;
+  typedef TCPIP::Write_some_op  Write_some_op;
+
+  Unix_socket(const std::string& path);
+
+private:
+
+  TCPIP_base::Impl& get_base_impl();
+};
+
+
 class TCPIP_base::IO_op : public Base::IO_op
 {
 protected:
@@ -176,21 +205,20 @@ protected:
 class TCPIP::Read_op : public IO_op
 {
 public:
-  Read_op(TCPIP &conn, const buffers &bufs, time_t deadline = 0);
+  Read_op(TCPIP_base &conn, const buffers &bufs, time_t deadline = 0);
 
   virtual bool do_cont();
   virtual void do_wait();
 
 private:
-  unsigned int m_currentBufferIdx;
-  size_t m_currentBufferOffset;
+  size_t m_bytesTransferred;
 };
 
 
 class TCPIP::Read_some_op : public IO_op
 {
 public:
-  Read_some_op(TCPIP &conn, const buffers &bufs, time_t deadline = 0);
+  Read_some_op(TCPIP_base &conn, const buffers &bufs, time_t deadline = 0);
 
   virtual bool do_cont();
   virtual void do_wait();
@@ -203,21 +231,20 @@ private:
 class TCPIP::Write_op : public IO_op
 {
 public:
-  Write_op(TCPIP &conn, const buffers &bufs, time_t deadline = 0);
+  Write_op(TCPIP_base &conn, const buffers &bufs, time_t deadline = 0);
 
   virtual bool do_cont();
   virtual void do_wait();
 
 private:
-  unsigned int m_currentBufferIdx;
-  size_t m_currentBufferOffset;
+  size_t m_bytesTransferred;
 };
 
 
 class TCPIP::Write_some_op : public IO_op
 {
 public:
-  Write_some_op(TCPIP &conn, const buffers &bufs, time_t deadline = 0);
+  Write_some_op(TCPIP_base &conn, const buffers &bufs, time_t deadline = 0);
 
   virtual bool do_cont();
   virtual void do_wait();
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This code is licensed under the terms of the GPLv2
+ * <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+ * MySQL Connectors. There are special exceptions to the terms and
+ * conditions of the GPLv2 as it is applied to this software, see the
+ * FLOSS License Exception
+ * <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+
+#ifndef SDK_FOUNDATION_VARINT_H
+#define SDK_FOUNDATION_VARINT_H
+
+/*
+  Decoding of variable length integers (varints) and zig-zag encoding
+  as used by Protobuf wire format.
+
+  See: https://developers.google.com/protocol-buffers/docs/encoding
+*/
+
+#include <mysql/cdk/config.h>
+#include "types.h"
+
+#include <string.h>   // memcpy
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+
+namespace cdk {
+namespace foundation {
+namespace varint {
+
+/*
+  Maximal number of bytes used by varint encoding of 64-bit number.
+*/
+
+const size_t max_length = 10;
+
+
+inline
+int64_t zigzag_decode(uint64_t val)
+{
+  return (int64_t)(val >> 1) ^ -(int64_t)(val & 1);
+}
+
+inline
+uint64_t zigzag_encode(int64_t val)
+{
+  return ((uint64_t)val << 1) ^ (uint64_t)(val >> 63);
+}
+
+
+namespace detail {
+
+// Index of the lowest bit set in a non-zero value.
+
+inline
+unsigned lowest_bit(uint64_t val)
+{
+#if defined(__GNUC__)
+  return (unsigned)__builtin_ctzll(val);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long pos;
+  _BitScanForward64(&pos, val);
+  return (unsigned)pos;
+#else
+  unsigned pos = 0;
+  for (; 0 == (val & 1); val >>= 1)
+    ++pos;
+  return pos;
+#endif
+}
+
+}  // detail
+
+
+/*
+  Decode single varint stored at `pos`, not reading past `end`.
+
+  Returns number of bytes consumed or 0 if the data does not contain
+  a valid varint (it is truncated or longer than max_length bytes).
+
+  On little-endian platforms, varints that fit in 8 bytes (that is,
+  values smaller than 2^56) are decoded without a loop: 8 bytes are
+  loaded into a single word, terminating byte is located using bit
+  operations and 7-bit groups are packed together in three steps.
+*/
+
+inline
+size_t decode(const byte *pos, const byte *end, uint64_t &val)
+{
+#if !CDK_BIG_ENDIAN
+
+  if (end - pos >= 8)
+  {
+    uint64_t word;
+    memcpy(&word, pos, 8);
+
+    // Bytes without continuation bit (0x80) terminate the varint.
+
+    uint64_t stop = ~word & 0x8080808080808080ULL;
+
+    if (0 != stop)
+    {
+      size_t len = (detail::lowest_bit(stop) >> 3) + 1;
+
+      if (len < 8)
+        word &= (1ULL << (8*len)) - 1;
+
+      word &= 0x7F7F7F7F7F7F7F7FULL;
+      word = (word & 0x007F007F007F007FULL)
+             | ((word & 0x7F007F007F007F00ULL) >> 1);
+      word = (word & 0x00003FFF00003FFFULL)
+             | ((word & 0x3FFF00003FFF0000ULL) >> 2);
+      word = (word & 0x000000000FFFFFFFULL)
+             | ((word & 0x0FFFFFFF00000000ULL) >> 4);
+
+      val = word;
+      return len;
+    }
+  }
+
+#endif
+
+  uint64_t res = 0;
+
+  for (size_t i = 0; i < max_length && pos + i < end; ++i)
+  {
+    res |= (uint64_t)(pos[i] & 0x7F) << (7*i);
+
+    if (0 == (pos[i] & 0x80))
+    {
+      val = res;
+      return i + 1;
+    }
+  }
+
+  return 0;
+}
+
+
+inline
+size_t decode(bytes buf, uint64_t &val)
+{
+  return decode(buf.begin(), buf.end(), val);
+}
+
+
+/*
+  Decode a column of fields, each holding a single varint, storing
+  decoded values in `vals` array (which must have room for `count`
+  values).
+
+  Returns number of successfully decoded fields - if it is less than
+  `count` then field at this position does not contain a valid varint.
+*/
+
+inline
+size_t decode(const bytes *fields, size_t count, uint64_t *vals)
+{
+  for (size_t i = 0; i < count; ++i)
+    if (0 == decode(fields[i].begin(), fields[i].end(), vals[i]))
+      return i;
+  return count;
+}
+
+
+/*
+  Like above, but also applies zig-zag decoding to the values.
+*/
+
+inline
+size_t decode_signed(const bytes *fields, size_t count, int64_t *vals)
+{
+  uint64_t raw;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (0 == decode(fields[i].begin(), fields[i].end(), raw))
+      return i;
+    vals[i] = zigzag_decode(raw);
+  }
+
+  return count;
+}
+
+}}}  // cdk::foundation::varint
+
+#endif
@@ -50,6 +50,15 @@ protected:
   Diagnostic_arena m_da;
   bool             m_error;
 
+  /*
+    Statement statistics saved when reply is discarded, so that they
+    are available also for pipelined replies that were discarded when
+    processing later ones.
+  */
+
+  Session::Stmt_stats m_stats;
+  bool             m_executed;
+
   Session& get_session()
   {
     if (!m_session)
@@ -62,6 +71,7 @@ public:
   Reply()
     : m_session(NULL)
     , m_error(false)
+    , m_executed(false)
   {}
 
   Reply(Reply_init& _init)
@@ -101,16 +111,12 @@ public:
 
   virtual row_count_t affected_rows()
   {
-    if (!m_session || has_results() || !m_session->m_executed)
-      throw_error("Only available after end of query execute");
-    return m_session->m_stmt_stats.rows_affected;
+    return get_stats().rows_affected;
   }
 
   row_count_t last_insert_id()
   {
-    if (!m_session || has_results() || !m_session->m_executed)
-      throw_error("Only available after end of query execute");
-    return m_session->m_stmt_stats.last_insert_id;
+    return get_stats().last_insert_id;
   }
 
   virtual void discard();
@@ -119,6 +125,19 @@ protected:
 
   void close_cursor();
 
+  const Session::Stmt_stats& get_stats()
+  {
+    if (!m_session)
+    {
+      if (!m_executed)
+        throw_error("Only available after end of query execute");
+      return m_stats;
+    }
+    if (has_results() || !m_session->m_executed)
+      throw_error("Only available after end of query execute");
+    return m_session->m_stmt_stats;
+  }
+
 private:
 
   //  Initialize class instance from Reply_init. Used on operator=()
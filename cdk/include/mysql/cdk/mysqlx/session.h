@@ -402,6 +402,25 @@ protected:
 
   Reply* m_current_reply;
 
+  /*
+    In pipelined mode, replies whose commands were already sent to the
+    server but which wait for earlier replies to be processed.
+  */
+
+  bool m_pipeline;
+  std::deque<Reply*> m_pipeline_queue;
+
+  /*
+    Replies to commands sent in pipelined mode which are not yet completed,
+    in command order, together with sizes of the command messages. Some of
+    these commands can still wait in the protocol output buffer (see
+    pipeline_flush()).
+  */
+
+  std::deque<std::pair<Reply*, size_t>> m_pipeline_cmds;
+
+  void pipeline_flush();
+
   SessionAuthInterface* m_auth_interface;
 
   shared_ptr<Proto_op> m_cmd;
@@ -415,7 +434,7 @@ protected:
   bool m_expired;
   string m_cur_schema;
 
-  struct
+  struct Stmt_stats
   {
     row_count_t  last_insert_id;
     row_count_t  rows_affected;
@@ -449,6 +468,7 @@ public:
     : m_protocol(conn)
     , m_isvalid(false)
     , m_current_reply(NULL)
+    , m_pipeline(false)
     , m_auth_interface(NULL)
     , m_cmd_args(NULL)
     , m_table(NULL)
@@ -488,6 +508,40 @@ public:
 
   void close();
 
+  /*
+    Reset session state on the server and re-authenticate the connection
+    using given options. After reset the session can be re-used as if it
+    was newly created.
+  */
+
+  void reset(const ds::Options&);
+
+  /*
+    Pipelining
+
+    When pipelining is enabled, a command is sent to the server as soon
+    as a Reply object is initialized with it, even if the reply to previous
+    command is not yet processed. Initializing a Reply does not discard the
+    current one - the new Reply waits in a queue and replies are processed
+    strictly in the order of commands. Waiting on (or discarding) a queued
+    Reply first discards all replies queued before it.
+
+    Messages of consecutive commands are serialized back-to-back into
+    the output buffer and written to the server together when a reply is
+    waited on (or earlier, if the buffer grows big). Only as many commands
+    are written as fit within a limit on the total size of commands whose
+    replies are not yet completed. Remaining commands are written when
+    earlier replies complete. This way the server can not block writing
+    replies that we do not read at the same time as we block writing
+    commands to it. Disabling pipelining does not write buffered commands
+    at once - they are written in the same way as replies are processed.
+  */
+
+  void set_pipeline(bool);
+
+  bool is_pipeline() const
+  { return m_pipeline; }
+
   /*
     Transactions
   */
@@ -606,6 +660,7 @@ private:
   //  Reply registration
   virtual void register_reply(Reply* reply);
   virtual void deregister_reply(Reply*);
+  void activate_reply(Reply*);
 
   /*
      Mdata_processor (cdk::protocol::mysqlx::Mdata_processor)
@@ -650,6 +705,7 @@ private:
   */
 
   void send_cmd();
+  void start_reply();
   void start_reading_result();
   Proto_op* start_reading_row_data(protocol::mysqlx::Row_processor &prc);
   void start_reading_stmt_reply();
@@ -480,6 +480,14 @@ public:
   Op& snd_AuthenticateContinue(bytes data);
   Op& snd_Close();
 
+  /**
+    Reset session state on the server. Server replies with Ok after which
+    the connection must be authenticated again before issuing further
+    commands.
+  */
+
+  Op& snd_SessionReset();
+
 
   /**
     Send protocol command which executes a statement.
@@ -604,6 +612,34 @@ public:
   Op& rcv_Rows(Row_processor &);
   Op& rcv_MetaData(Mdata_processor &);
 
+  /**
+    Enable or disable pipelining of client messages.
+
+    In pipelined mode messages sent with snd_XXX() methods are serialized
+    into the output buffer and the send operations complete immediately,
+    without waiting for I/O. Buffered messages are sent only by
+    pipeline_flush() or when pipelining is disabled, which sends all
+    pending messages.
+
+    Note: The caller is responsible for sending messages before waiting
+    for replies to them. It should also limit the amount of messages sent
+    ahead of reading replies. Otherwise, if the other end blocks writing
+    replies that are not read, writing more messages to it blocks too.
+  */
+
+  void set_pipeline(bool);
+
+  /// Number of bytes of pipelined messages which were not sent yet.
+
+  size_t pipeline_pending() const;
+
+  /**
+    Send the first `len` bytes of pipelined messages, which should contain
+    complete messages. This is a blocking operation.
+  */
+
+  void pipeline_flush(size_t len);
+
 private:
 
   class Impl;
@@ -662,6 +698,11 @@ private:
   create read or write operation, respectively, using appropriate operation
   type C::Read_op or C::Write_op. This operation is allocated dynamically
   and should be deleted by the caller of the method.
+
+  Method read_some() creates C::Read_some_op operation which completes as
+  soon as some bytes are read into the buffer (but not necessarily all of
+  them). It is used by protocol implementation to read ahead as many bytes
+  as are available in the stream.
 */
 
 class Protocol::Stream
@@ -676,6 +717,7 @@ public:
   {}
 
   virtual Op* read(const buffers&) =0;
+  virtual Op* read_some(const buffers&) =0;
   virtual Op* write(const buffers&) =0;
 
 private:
@@ -695,8 +737,9 @@ private:
 template <class C>
 class Protocol::Stream::Impl : public Stream
 {
-  typedef typename C::Read_op  Rd_op;
-  typedef typename C::Write_op Wr_op;
+  typedef typename C::Read_op       Rd_op;
+  typedef typename C::Read_some_op  Rd_some_op;
+  typedef typename C::Write_op      Wr_op;
 
   C &m_conn;
 
@@ -705,6 +748,9 @@ class Protocol::Stream::Impl : public Stream
   Op* read(const buffers &buf)
   { return new Rd_op(m_conn, buf); }
 
+  Op* read_some(const buffers &buf)
+  { return new Rd_some_op(m_conn, buf); }
+
   Op* write(const buffers &buf)
   { return new Wr_op(m_conn, buf); }
 
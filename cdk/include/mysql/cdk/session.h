@@ -58,9 +58,13 @@ public:
 
   /// Create session to a data store represented by `ds` object.
 
-  Session(ds::TCPIP &ds,
+  Session(const ds::TCPIP &ds,
           const ds::TCPIP::Options &options = ds::TCPIP::Options());
 
+  Session(const ds::Unix_socket &ds,
+          const ds::Unix_socket::Options &options
+            = ds::Unix_socket::Options());
+
   ~Session();
 
   // Core Session operations.
@@ -75,6 +79,17 @@ public:
     m_connection->close();
   }
 
+  /*
+    Reset session state on the server, rolling back any open transaction,
+    and authenticate again using given options. This allows re-using
+    the underlying connection for a new session.
+  */
+
+  void reset(const ds::Options &options) {
+    m_trans = false;
+    m_session->reset(options);
+  }
+
   /*
     Transactions
     ------------
@@ -150,6 +165,17 @@ public:
 
   void clear_errors() { return m_session->clear_errors(); }
 
+  /*
+    Pipelining
+    ----------
+    When pipelining is on, commands are sent to the server without
+    waiting for replies to earlier commands. Replies are processed
+    in the order of commands (see mysqlx::Session for details).
+  */
+
+  void set_pipeline(bool on) { m_session->set_pipeline(on); }
+  bool is_pipeline() const { return m_session->is_pipeline(); }
+
   /*
     Data manipulation
     -----------------
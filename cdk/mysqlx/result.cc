@@ -57,13 +57,21 @@ Reply::~Reply()
 void Reply::init(Reply_init &init)
 {
   m_error = false;
+  m_executed = false;
   m_da.clear();
   m_session = &init;
 
   init.register_reply(this);
 
   m_session->send_cmd();
-  m_session->start_reading_result();
+
+  /*
+    A pipelined reply which is queued after other replies starts reading
+    its results only when it becomes the current one.
+  */
+
+  if (this == m_session->m_current_reply)
+    m_session->start_reply();
 }
 
 
@@ -72,7 +80,10 @@ void Reply::close_cursor()
   if (NULL == m_session)
     return;
 
-  assert(this == m_session->m_current_reply);
+  // Pipelined reply which is not current can not have a cursor.
+
+  if (this != m_session->m_current_reply)
+    return;
 
   if (m_session->m_current_cursor)
     m_session->m_current_cursor->close();
@@ -86,7 +97,7 @@ void Reply::discard()
   if (NULL == m_session)
     return;
 
-  assert(this == m_session->m_current_reply);
+  m_session->activate_reply(this);
 
   if (m_session->m_current_cursor)
     throw_error("Cursor in usage!");
@@ -99,6 +110,10 @@ void Reply::discard()
   }
 
   m_session->m_discard = false;
+
+  m_stats = m_session->m_stmt_stats;
+  m_executed = m_session->m_executed;
+
   m_session->deregister_reply(this);
   m_session = NULL;
 }
@@ -109,7 +124,7 @@ bool Reply::has_results()
   if (NULL == m_session)
     return false;
 
-  assert(this == m_session->m_current_reply);
+  m_session->activate_reply(this);
 
   // If we hit error, do not continue.
 
@@ -132,7 +147,7 @@ void Reply::skip_result()
   if (NULL == m_session)
     throw_error("Session not initialized");
 
-  assert(this == m_session->m_current_reply);
+  m_session->activate_reply(this);
 
   if (entry_count() > 0)
     return;
@@ -160,7 +175,10 @@ bool Reply::is_completed() const
   if (!m_session)
     return true;
 
-  assert(this == m_session->m_current_reply);
+  // Pipelined reply waiting in the queue is not completed yet.
+
+  if (this != m_session->m_current_reply)
+    return false;
 
   if (!m_session->m_reply_op_queue.empty())
     return false;
@@ -174,7 +192,7 @@ bool Reply::do_cont()
   if (!m_session)
     return true;
 
-  assert(this == m_session->m_current_reply);
+  m_session->activate_reply(this);
 
   if (m_session->m_reply_op_queue.empty())
     return true;
@@ -206,6 +224,9 @@ bool Reply::do_cont()
 
 void Reply::do_wait()
 {
+  if (m_session)
+    m_session->activate_reply(this);
+
   while (m_session && !m_session->m_reply_op_queue.empty())
   {
     assert(this == m_session->m_current_reply);
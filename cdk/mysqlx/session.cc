@@ -246,11 +246,31 @@ option_t Session::is_valid()
 }
 
 
+/*
+  Check that the server still responds by executing an empty statement.
+  If a reply is being processed then the session is in use and only
+  the local check is done. A session whose connection fails during
+  the check becomes invalid.
+*/
+
 option_t Session::check_valid()
 {
-  //TODO: contact server to check session
+  if (!is_valid())
+    return false;
+
+  if (m_current_reply)
+    return true;
 
-  return  is_valid() ? true : false;
+  try {
+    Reply r(sql(L"DO NULL", NULL));
+    r.wait();
+  }
+  catch (...)
+  {
+    m_isvalid = false;
+  }
+
+  return is_valid() ? true : false;
 }
 
 
@@ -258,8 +278,14 @@ void Session::close()
 {
   m_reply_op_queue.clear();
 
+  m_pipeline = false;
+  m_pipeline_cmds.clear();
+
   if (is_valid())
   {
+    // Write buffered pipelined commands so that Close is not left behind.
+
+    m_protocol.set_pipeline(false);
     m_protocol.snd_Close().wait();
     //    TODO: Uncomment this line when srever implements Close OK reply message
     //    m_protocol.rcv_Reply(*this).wait();
@@ -268,11 +294,55 @@ void Session::close()
 
 }
 
+/*
+  Reset session state on the server (session variables, temporary tables,
+  open transaction, current schema etc.) and authenticate again using
+  given options, so that the connection can be re-used as if it was
+  a freshly opened session. Pending replies are discarded first.
+*/
+
+void Session::reset(const ds::Options &options)
+{
+  while (m_current_reply)
+  {
+    m_current_reply->close_cursor();
+    m_current_reply->discard();
+  }
+
+  if (!is_valid())
+    throw_error("reset: invalid session");
+
+  clear_errors();
+
+  m_protocol.snd_SessionReset().wait();
+  m_protocol.rcv_Reply(*this).wait();
+
+  if (entry_count() > 0)
+    get_error().rethrow();
+
+  m_isvalid = false;
+  m_cur_schema = string();
+  m_stmt_stats.clear();
+
+  authenticate(options);
+
+  if (!is_valid())
+    get_error().rethrow();
+}
+
 void Session::register_reply(Reply *reply)
 {
-  // Complete previous reply
+  // In pipelined mode new reply is queued after the current one.
 
-  if (m_current_reply)
+  if (m_pipeline && m_current_reply)
+  {
+    m_pipeline_queue.push_back(reply);
+    return;
+  }
+
+  // Complete previous reply (and pipelined replies queued after it)
+
+  while (m_current_reply)
   {
     m_current_reply->close_cursor();
     m_current_reply->discard();
@@ -284,6 +354,116 @@ void Session::deregister_reply(Reply *reply)
 {
   // TODO: Should reply be discared here?
   m_current_reply = NULL;
+
+  if (!m_pipeline_cmds.empty() && reply == m_pipeline_cmds.front().first)
+    m_pipeline_cmds.pop_front();
+
+  // Next pipelined reply, if any, becomes the current one.
+
+  if (!m_pipeline_queue.empty())
+  {
+    m_current_reply = m_pipeline_queue.front();
+    m_pipeline_queue.pop_front();
+    start_reply();
+  }
+}
+
+
+/*
+  Make given pipelined reply the current one, discarding all replies
+  that were queued before it.
+*/
+
+void Session::activate_reply(Reply *reply)
+{
+  while (m_current_reply && m_current_reply != reply)
+  {
+    m_current_reply->close_cursor();
+    m_current_reply->discard();
+  }
+
+  assert(reply == m_current_reply);
+
+  // Pipelined commands are written when their replies are waited on.
+
+  pipeline_flush();
+}
+
+
+/*
+  Note: When pipelining is turned off, pipelined commands which are not
+  yet written to the server stay in the protocol output buffer. They are
+  written by pipeline_flush() as replies are processed and protocol
+  pipelining is turned off only when all of them are written.
+*/
+
+void Session::set_pipeline(bool on)
+{
+  m_pipeline = on;
+  if (on || 0 == m_protocol.pipeline_pending())
+    m_protocol.set_pipeline(on);
+}
+
+
+/*
+  Limit for the total size of pipelined commands written to the server
+  whose replies are not yet completed (see pipeline_flush()).
+*/
+
+static const size_t pipeline_max_bytes = 64*1024;
+
+
+/*
+  Write buffered pipelined commands to the server, as many as fit within
+  pipeline_max_bytes limit. The oldest command, whose reply is processed
+  first, is always written.
+
+  Commands in m_pipeline_cmds are already written except for the last ones,
+  whose messages are still in the protocol output buffer.
+*/
+
+void Session::pipeline_flush()
+{
+  size_t pending = m_protocol.pipeline_pending();
+
+  if (0 == pending)
+  {
+    if (!m_pipeline)
+      m_protocol.set_pipeline(false);
+    return;
+  }
+
+  size_t total = 0;
+  for (auto &cmd : m_pipeline_cmds)
+    total += cmd.second;
+
+  if (total < pending)
+  {
+    m_protocol.pipeline_flush(pending);
+    if (!m_pipeline)
+      m_protocol.set_pipeline(false);
+    return;
+  }
+
+  size_t written = total - pending;
+  size_t pos = 0;
+  size_t len = 0;
+
+  for (auto &cmd : m_pipeline_cmds)
+  {
+    if (pos >= written)
+    {
+      if (pos > 0 && written + len + cmd.second > pipeline_max_bytes)
+        break;
+      len += cmd.second;
+    }
+    pos += cmd.second;
+  }
+
+  m_protocol.pipeline_flush(len);
+
+  if (!m_pipeline && len == pending)
+    m_protocol.set_pipeline(false);
 }
 
 
@@ -725,10 +905,50 @@ void Session::row_stats(row_stats_t stats, row_count_t val)
 
 void Session::send_cmd()
 {
-  m_executed = false;
+  if (m_pipeline)
+  {
+    /*
+      In pipelined mode sending a command only serializes it into the
+      protocol output buffer, so it is done right away, before replies
+      to earlier commands are processed. The reply to this command was
+      just registered.
+    */
+
+    size_t pending = m_protocol.pipeline_pending();
+
+    m_cmd->wait();
+    m_cmd.reset();
+
+    Reply *reply = m_pipeline_queue.empty() ? m_current_reply
+                                            : m_pipeline_queue.back();
+    m_pipeline_cmds.emplace_back(reply,
+                                 m_protocol.pipeline_pending() - pending);
+
+    /*
+      Commands stay in the output buffer, to be sent together when a reply
+      is waited on (see activate_reply()), unless there are many of them.
+    */
+
+    if (m_protocol.pipeline_pending() >= pipeline_max_bytes)
+      pipeline_flush();
+    return;
+  }
+
   m_reply_op_queue.push_back(m_cmd);
   m_cmd.reset();
+}
+
+
+/*
+  Start processing reply to the last command sent (or to the next
+  pipelined command if the reply is taken from the pipeline queue).
+*/
+
+void Session::start_reply()
+{
+  m_executed = false;
   m_stmt_stats.clear();
+  start_reading_result();
 }
 
 
@@ -557,6 +557,91 @@ TEST_F(Session_mysqlx,sql_basic)
 }
 
 
+/*
+  Row processor which only counts the bytes of field data it sees.
+*/
+
+class Count_bytes
+    : public cdk::mysqlx::Row_processor
+{
+public:
+
+  size_t m_rows;
+  size_t m_bytes;
+
+  Count_bytes() : m_rows(0), m_bytes(0)
+  {}
+
+  virtual bool row_begin(row_count_t)
+  {
+    m_rows++;
+    return true;
+  }
+  virtual void row_end(row_count_t) {}
+  virtual void field_null(col_count_t) {}
+  virtual size_t field_begin(col_count_t, size_t) { return SIZE_MAX; }
+  virtual void field_end(col_count_t) {}
+
+  virtual size_t field_data(col_count_t, bytes data)
+  {
+    m_bytes += data.size();
+    return SIZE_MAX;
+  }
+
+  virtual void end_of_data() {}
+};
+
+
+/*
+  Send many big statements in pipeline mode before reading any of the
+  replies. Both the statements and their results are bigger than what
+  socket buffers can hold, so this would block if the session did not
+  bound the amount of output it sends ahead of the replies.
+*/
+
+TEST_F(Session_mysqlx, pipeline)
+{
+  try {
+    SKIP_IF_NO_XPLUGIN;
+
+    cdk::ds::Options options;
+    cdk::mysqlx::Session s(get_conn(), options);
+
+    const size_t len = 100000;
+    const unsigned cnt = 32;
+
+    std::wstring query(L"SELECT '");
+    query.append(len, L'x');
+    query.append(L"' AS big");
+
+    s.set_pipeline(true);
+
+    cdk::mysqlx::Reply rp[cnt];
+
+    for (unsigned i = 0; i < cnt; ++i)
+      rp[i] = s.sql(query, NULL);
+
+    s.set_pipeline(false);
+
+    for (unsigned i = 0; i < cnt; ++i)
+    {
+      EXPECT_TRUE(rp[i].has_results());
+
+      cdk::mysqlx::Cursor cr(rp[i]);
+      Count_bytes cb;
+
+      cr.get_rows(cb);
+      cr.wait();
+
+      EXPECT_EQ(1U, cb.m_rows);
+      // Note: string field data includes trailing '\0' byte.
+      EXPECT_EQ(len + 1, cb.m_bytes);
+    }
+  }
+  CATCH_TEST_GENERIC
+}
+
+
 template <typename GetType, typename TestType, cdk::Type_info TI>
 class PrintCompareType
     : public cdk::mysqlx::Row_processor
@@ -293,7 +293,7 @@ std::string Expr_parser_base::cast_data_type_dimension(bool double_dimension)
    | QUOTED_ID
  */
 
-const std::string &Expr_parser_base::get_ident()
+std::string Expr_parser_base::get_ident()
 {
   if (cur_token_type_is(Token::ID))
   {
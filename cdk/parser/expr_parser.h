@@ -261,7 +261,7 @@ protected:
   void parse_schema_ident(Token::TokenType (*types)[2] = NULL);
   void parse_column_ident(Path_prc*);
   void parse_column_ident1(Path_prc*);
-  const std::string &get_ident();
+  std::string get_ident();
 
   void parse_document_field(Path_prc*, bool prefix = false);
   void parse_document_field(const cdk::string&, Path_prc*);
@@ -27,8 +27,23 @@
 
 PUSH_SYS_WARNINGS
 #include <stdlib.h>
+#include <cctype>
+#include <algorithm>
 POP_SYS_WARNINGS
 
+/*
+  SSE2 is used (if available) to quickly skip string characters which
+  do not need special processing.
+*/
+
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_USE_SSE2
+PUSH_SYS_WARNINGS
+#include <emmintrin.h>
+POP_SYS_WARNINGS
+#endif
+
 PUSH_SYS_WARNINGS
 PUSH_BOOST_WARNINGS
 #include <boost/lexical_cast.hpp>
@@ -140,3 +155,580 @@ bool JSON_scalar_parser::do_parse(It &first, const It &last, Processor *vp)
 }
 
 
+/*
+  JSON_utf8_parser
+  ================
+
+  The parser is implemented by Scanner class which keeps current position
+  in the input and has methods for parsing different kinds of JSON values,
+  reporting them to processors as they go. A NULL processor means that
+  parsed value should be ignored.
+*/
+
+typedef JSON::Processor::Any_prc   Any_prc;
+typedef Any_prc::Scalar_prc        Scalar_prc;
+typedef Any_prc::Doc_prc           Doc_prc;
+typedef Any_prc::List_prc          List_prc;
+
+
+namespace {
+
+class Scanner
+{
+  const char *m_pos;
+  const char *m_end;
+
+public:
+
+  Scanner(const char *begin, const char *end)
+    : m_pos(begin), m_end(end)
+  {}
+
+  /*
+    Skip white space and return next character, or 0 if whole input
+    has been consumed.
+  */
+
+  char peek()
+  {
+    while (m_pos < m_end && std::isspace((unsigned char)*m_pos))
+      ++m_pos;
+    return m_pos < m_end ? *m_pos : 0;
+  }
+
+  bool at_end()
+  {
+    return 0 == peek();
+  }
+
+  const char* pos() const { return m_pos; }
+
+  void parse_doc(Doc_prc*);
+  void parse_arr(List_prc*);
+  void parse_any(Any_prc*);
+  void parse_scalar(Scalar_prc*);
+
+  void expect(char c, const char *msg)
+  {
+    if (c != peek())
+      throw Error(msg);
+    ++m_pos;
+  }
+
+  void parse_key(std::string&);
+
+private:
+
+  void parse_string(std::string&);
+  void skip_string();
+  void parse_number(Scalar_prc*);
+  void parse_word(std::string&);
+  void parse_escape(std::string&);
+
+  static const char* find_special(const char*, const char*, char);
+  static void append_utf8(std::string&, unsigned long);
+};
+
+}  // anonymous namespace
+
+
+void JSON_utf8_parser::process(Processor &prc) const
+{
+  Scanner scanner(m_begin, m_end);
+
+  if (scanner.at_end())
+    cdk::throw_error("JSON_parser: empty string");
+
+  if ('{' != scanner.peek())
+    cdk::throw_error("JSON_parser: could not parse string as JSON document");
+
+  scanner.parse_doc(&prc);
+
+  if (!scanner.at_end())
+    cdk::throw_error("JSON_parser: could not parse string as JSON document");
+}
+
+
+void JSON_utf8_parser::index(Index &idx) const
+{
+  Scanner scanner(m_begin, m_end);
+
+  idx.clear();
+
+  if (scanner.at_end())
+    cdk::throw_error("JSON_parser: empty string");
+
+  scanner.expect('{', "JSON_parser: could not parse string as JSON document");
+
+  if ('}' != scanner.peek())
+  {
+    Key_pos entry;
+
+    for (;;)
+    {
+      scanner.parse_key(entry.key);
+      scanner.expect(':', "Document parser: Expected ':' after key name");
+      scanner.peek();
+      entry.begin = (size_t)(scanner.pos() - m_begin);
+      scanner.parse_any(NULL);
+      entry.end = (size_t)(scanner.pos() - m_begin);
+      idx.push_back(entry);
+
+      if (',' != scanner.peek())
+        break;
+      scanner.expect(',', "Document parser: Expected ','");
+    }
+  }
+
+  scanner.expect('}', "Document parser: Expected closing '}'");
+
+  if (!scanner.at_end())
+    cdk::throw_error("JSON_parser: could not parse string as JSON document");
+
+  std::stable_sort(idx.begin(), idx.end(),
+    [](const Key_pos &a, const Key_pos &b) { return a.key < b.key; });
+
+  idx.erase(
+    std::unique(idx.begin(), idx.end(),
+      [](const Key_pos &a, const Key_pos &b) { return a.key == b.key; }),
+    idx.end());
+}
+
+
+void JSON_utf8_parser::process_value(cdk::bytes data, Processor::Any_prc &prc)
+{
+  Scanner scanner((const char*)data.begin(), (const char*)data.end());
+
+  scanner.parse_any(&prc);
+
+  if (!scanner.at_end())
+    cdk::throw_error("JSON_parser: could not parse JSON value");
+}
+
+
+void Scanner::parse_doc(Doc_prc *prc)
+{
+  expect('{', "Document parser: Expected '{'");
+
+  if (prc)
+    prc->doc_begin();
+
+  if ('}' != peek())
+  {
+    std::string key;
+
+    for (;;)
+    {
+      parse_key(key);
+      expect(':', "Document parser: Expected ':' after key name");
+      parse_any(prc ? prc->key_val(cdk::string(key)) : NULL);
+
+      if (',' != peek())
+        break;
+      ++m_pos;
+    }
+  }
+
+  expect('}', "Document parser: Expected closing '}'");
+
+  if (prc)
+    prc->doc_end();
+}
+
+
+void Scanner::parse_arr(List_prc *prc)
+{
+  expect('[', "Array parser: expected '['");
+
+  if (prc)
+    prc->list_begin();
+
+  if (']' != peek())
+  {
+    for (;;)
+    {
+      parse_any(prc ? prc->list_el() : NULL);
+
+      if (',' != peek())
+        break;
+      ++m_pos;
+    }
+  }
+
+  expect(']', "Array parser: expected closing ']'");
+
+  if (prc)
+    prc->list_end();
+}
+
+
+void Scanner::parse_any(Any_prc *prc)
+{
+  switch (peek())
+  {
+  case '{': parse_doc(prc ? prc->doc() : NULL); return;
+  case '[': parse_arr(prc ? prc->arr() : NULL); return;
+  case 0:   throw Error("Document parser: expected value for a key");
+  default:  parse_scalar(prc ? prc->scalar() : NULL); return;
+  }
+}
+
+
+void Scanner::parse_scalar(Scalar_prc *prc)
+{
+  char c = peek();
+
+  if ('"' == c || '\'' == c)
+  {
+    if (!prc)
+    {
+      skip_string();
+      return;
+    }
+
+    std::string val;
+    parse_string(val);
+    if (prc)
+      prc->str(cdk::string(val));
+    return;
+  }
+
+  if (std::isalpha((unsigned char)c) || '_' == c)
+  {
+    std::string word;
+    parse_word(word);
+
+    // Note: like in JSON_parser, literals are not case sensitive.
+
+    for (char &x : word)
+      x = (char)std::tolower((unsigned char)x);
+
+    if ("null" == word)
+    {
+      if (prc)
+        prc->null();
+      return;
+    }
+
+    if ("true" == word || "false" == word)
+    {
+      if (prc)
+        prc->yesno("true" == word);
+      return;
+    }
+
+    throw Error("Can not parse key value");
+  }
+
+  parse_number(prc);
+}
+
+
+void Scanner::parse_key(std::string &key)
+{
+  char c = peek();
+
+  key.clear();
+
+  // Note: official JSON specs do not allow plain ID as key name
+
+  if ('"' == c || '\'' == c)
+    parse_string(key);
+  else if (std::isalpha((unsigned char)c) || '_' == c)
+    parse_word(key);
+  else
+    throw Error("Document parser: expected key-value pair");
+}
+
+
+void Scanner::parse_word(std::string &word)
+{
+  const char *start = m_pos;
+
+  while (m_pos < m_end
+         && (std::isalnum((unsigned char)*m_pos) || '_' == *m_pos))
+    ++m_pos;
+
+  word.assign(start, m_pos);
+}
+
+
+/*
+  Parse quoted string, storing its UTF-8 encoded value in `val`. Escape
+  sequences are replaced by characters they represent. As in JSON_parser,
+  doubled quote character stands for a single quote inside the string
+  and unknown escape sequence \X is replaced by X.
+*/
+
+void Scanner::parse_string(std::string &val)
+{
+  const char quote = *m_pos++;
+
+  val.clear();
+
+  for (;;)
+  {
+    const char *pos = find_special(m_pos, m_end, quote);
+
+    val.append(m_pos, pos);
+    m_pos = pos;
+
+    if (m_pos >= m_end)
+      throw Error("Unterminated quoted string");
+
+    if ('\\' == *m_pos)
+    {
+      ++m_pos;
+      parse_escape(val);
+      continue;
+    }
+
+    // Closing quote, unless it is doubled.
+
+    ++m_pos;
+
+    if (m_pos < m_end && quote == *m_pos)
+    {
+      val.push_back(quote);
+      ++m_pos;
+      continue;
+    }
+
+    return;
+  }
+}
+
+
+/*
+  Move past quoted string without decoding its value.
+*/
+
+void Scanner::skip_string()
+{
+  const char quote = *m_pos++;
+
+  for (;;)
+  {
+    m_pos = find_special(m_pos, m_end, quote);
+
+    if (m_pos >= m_end)
+      throw Error("Unterminated quoted string");
+
+    if ('\\' == *m_pos)
+    {
+      m_pos += 2;
+      continue;
+    }
+
+    ++m_pos;
+
+    if (m_pos < m_end && quote == *m_pos)
+    {
+      ++m_pos;
+      continue;
+    }
+
+    return;
+  }
+}
+
+
+/*
+  Return position of the first quote or backslash character in the given
+  range, or the end of the range if there are no such characters.
+*/
+
+const char* Scanner::find_special(const char *pos, const char *end,
+                                  char quote)
+{
+#ifdef JSON_USE_SSE2
+
+  const __m128i quote_v = _mm_set1_epi8(quote);
+  const __m128i slash_v = _mm_set1_epi8('\\');
+
+  for (; end - pos >= 16; pos += 16)
+  {
+    __m128i chunk = _mm_loadu_si128((const __m128i*)pos);
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote_v),
+                                _mm_cmpeq_epi8(chunk, slash_v));
+    if (0 != _mm_movemask_epi8(hits))
+      break;
+  }
+
+#endif
+
+  for (; pos < end; ++pos)
+    if (quote == *pos || '\\' == *pos)
+      return pos;
+
+  return end;
+}
+
+
+void Scanner::parse_escape(std::string &val)
+{
+  if (m_pos >= m_end)
+    throw Error("Unterminated quoted string");
+
+  char c = *m_pos++;
+
+  switch (c)
+  {
+  case 'b': val.push_back('\b'); return;
+  case 'f': val.push_back('\f'); return;
+  case 'n': val.push_back('\n'); return;
+  case 'r': val.push_back('\r'); return;
+  case 't': val.push_back('\t'); return;
+  case 'u': break;
+  default:  val.push_back(c); return;
+  }
+
+  // \uXXXX escape, possibly followed by another one for surrogate pair.
+
+  auto hex4 = [this]() -> unsigned long
+  {
+    if (m_end - m_pos < 4)
+      throw Error("Invalid \\u escape sequence in a string");
+
+    unsigned long code = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+      char x = *m_pos++;
+      code <<= 4;
+      if (x >= '0' && x <= '9')
+        code |= (unsigned long)(x - '0');
+      else if (x >= 'a' && x <= 'f')
+        code |= (unsigned long)(x - 'a' + 10);
+      else if (x >= 'A' && x <= 'F')
+        code |= (unsigned long)(x - 'A' + 10);
+      else
+        throw Error("Invalid \\u escape sequence in a string");
+    }
+
+    return code;
+  };
+
+  unsigned long code = hex4();
+
+  if (code >= 0xD800 && code < 0xDC00
+      && m_end - m_pos >= 6 && '\\' == m_pos[0] && 'u' == m_pos[1])
+  {
+    m_pos += 2;
+    unsigned long low = hex4();
+    if (low < 0xDC00 || low >= 0xE000)
+      throw Error("Invalid surrogate pair in a string");
+    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+  }
+
+  append_utf8(val, code);
+}
+
+
+void Scanner::append_utf8(std::string &val, unsigned long code)
+{
+  if (code < 0x80)
+  {
+    val.push_back((char)code);
+  }
+  else if (code < 0x800)
+  {
+    val.push_back((char)(0xC0 | (code >> 6)));
+    val.push_back((char)(0x80 | (code & 0x3F)));
+  }
+  else if (code < 0x10000)
+  {
+    val.push_back((char)(0xE0 | (code >> 12)));
+    val.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+    val.push_back((char)(0x80 | (code & 0x3F)));
+  }
+  else
+  {
+    val.push_back((char)(0xF0 | (code >> 18)));
+    val.push_back((char)(0x80 | ((code >> 12) & 0x3F)));
+    val.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+    val.push_back((char)(0x80 | (code & 0x3F)));
+  }
+}
+
+
+/*
+  Parse numeric value. Integer values are reported the same way as
+  in JSON_scalar_parser::do_parse().
+*/
+
+void Scanner::parse_number(Scalar_prc *prc)
+{
+  bool neg = false;
+
+  if ('-' == *m_pos || '+' == *m_pos)
+  {
+    neg = ('-' == *m_pos);
+    ++m_pos;
+  }
+
+  const char *start = m_pos;
+  bool is_float = false;
+  uint64_t val = 0;
+  bool overflow = false;
+
+  for (; m_pos < m_end && std::isdigit((unsigned char)*m_pos); ++m_pos)
+  {
+    unsigned digit = (unsigned)(*m_pos - '0');
+    if (val > (UINT64_MAX - digit) / 10)
+      overflow = true;
+    val = 10*val + digit;
+  }
+
+  if (m_pos < m_end && '.' == *m_pos)
+  {
+    is_float = true;
+    ++m_pos;
+    while (m_pos < m_end && std::isdigit((unsigned char)*m_pos))
+      ++m_pos;
+  }
+
+  if (m_pos == start || (is_float && m_pos == start + 1))
+    throw Error("Can not parse key value");
+
+  if (m_pos < m_end && ('e' == *m_pos || 'E' == *m_pos))
+  {
+    is_float = true;
+    ++m_pos;
+    if (m_pos < m_end && ('-' == *m_pos || '+' == *m_pos))
+      ++m_pos;
+    if (m_pos >= m_end || !std::isdigit((unsigned char)*m_pos))
+      throw Error("Can not parse key value");
+    while (m_pos < m_end && std::isdigit((unsigned char)*m_pos))
+      ++m_pos;
+  }
+
+  if (!prc)
+    return;
+
+  if (is_float)
+  {
+    double dval = boost::lexical_cast<double>(std::string(start, m_pos));
+    prc->num(neg ? -dval : dval);
+    return;
+  }
+
+  if (overflow)
+    throw Error("The value is too large for a signed type");
+
+  if (val > INTEGER_ABS_MAX)
+  {
+    if (neg)
+      throw Error("The value is too large for a signed type");
+    // Unsigned type is only returned for large values
+    prc->num(val);
+  }
+  else
+  {
+    // Absolute values of 9223372036854775808UL can only be negative
+    if (!neg && val == INTEGER_ABS_MAX)
+      throw Error("The value is too large for a signed type");
+    // All values ABS(val) < 9223372036854775808UL are treated as signed
+    prc->num(neg ? -(int64_t)val : (int64_t)val);
+  }
+}
@@ -27,6 +27,8 @@
 
 #include <mysql/cdk/common.h>
 #include "parser.h"
+#include <string>
+#include <vector>
 
 namespace parser {
 
@@ -94,6 +96,66 @@ public:
 
 };
 
+
+/*
+  JSON parser which works directly on UTF-8 encoded bytes.
+
+  Unlike JSON_parser, it does not split input into a list of tokens
+  first. The input is scanned once and parsed values are reported to
+  the processor as soon as they are recognized. Only strings and keys
+  reported to the processor are converted to cdk::string.
+
+  Apart from standard JSON syntax, the parser accepts the same extensions
+  as JSON_parser: single-quoted strings, unquoted key names, '+' sign in
+  front of numbers and numbers starting with '.'. Parsing stops at 0x00
+  byte, if present.
+*/
+
+class JSON_utf8_parser
+  : public JSON
+{
+  const char *m_begin;
+  const char *m_end;
+
+public:
+
+  JSON_utf8_parser(cdk::bytes data)
+    : m_begin((const char*)data.begin())
+    , m_end((const char*)data.end())
+  {}
+
+  void process(Processor &prc) const;
+
+  /*
+    Index of top-level document fields. Each entry holds UTF-8 encoded
+    key name and the range of bytes occupied by the key's value, given
+    as offsets from the beginning of the input. Entries are sorted by key
+    name. If a key is repeated, only its first occurrence is indexed.
+  */
+
+  struct Key_pos
+  {
+    std::string key;
+    size_t      begin;
+    size_t      end;
+  };
+
+  typedef std::vector<Key_pos> Index;
+
+  /*
+    Scan the document and fill the index without decoding any values.
+  */
+
+  void index(Index&) const;
+
+  /*
+    Parse a single JSON value, such as the one described by an index
+    entry, and report it to the given processor.
+  */
+
+  static void process_value(cdk::bytes, Processor::Any_prc&);
+};
+
 }  // parser
 
 #endif
@@ -73,7 +73,7 @@ protected:
   It  *m_first;
   It  m_last;
 
-  const std::string& consume_token(Token::TokenType type)
+  std::string consume_token(Token::TokenType type)
   {
     if (!cur_token_type_is(type))
       unexpected_token(peek_token(), (boost::format("while looking for token %s")
@@ -310,6 +310,109 @@ TEST(Parser, json)
 
 
 
+/*
+  Check that JSON_utf8_parser reports the same values as JSON_parser.
+*/
+
+TEST(Parser, json_utf8)
+{
+  for (unsigned i=0; i < sizeof(docs)/sizeof(wchar_t*); i++)
+  {
+    cout <<endl <<"== doc#" <<i <<" ==" <<endl<<endl;
+
+    std::string doc = cdk::string(docs[i]);
+
+    std::ostringstream expected;
+    JSON_printer printer(expected, 0);
+    JSON_parser parser(doc);
+    parser.process(printer);
+
+    std::ostringstream out;
+    JSON_printer printer1(out, 0);
+    JSON_utf8_parser parser1((cdk::bytes(doc)));
+    parser1.process(printer1);
+
+    cout << out.str();
+    EXPECT_EQ(expected.str(), out.str());
+  }
+
+  // Escape sequences and non-ASCII characters.
+
+  struct : public JSON::Processor
+         , public JSON::Processor::Any_prc
+         , public JSON::Processor::Any_prc::Scalar_prc
+  {
+    cdk::string m_key;
+    cdk::string m_val;
+    int64_t     m_num = 0;
+
+    void null() {}
+    void str(const cdk::string &val) { m_val = val; }
+    void num(uint64_t) {}
+    void num(int64_t val) { m_num = val; }
+    void num(float) {}
+    void num(double) {}
+    void yesno(bool) {}
+
+    Scalar_prc* scalar() { return this; }
+    Doc_prc *doc() { return NULL; }
+    List_prc *arr() { return NULL; }
+
+    void doc_begin() {}
+    void doc_end() {}
+    Any_prc* key_val(const cdk::string &key)
+    {
+      m_key = key;
+      return this;
+    }
+  }
+  checker;
+
+  {
+    std::string doc
+      = "{\"k\\u00e9y\": \"a\\\"b\\\\c\\nd\\u0105\\ud83d\\ude00 \xc5\x9b\"}\0";
+    JSON_utf8_parser parser((cdk::bytes(doc)));
+    parser.process(checker);
+    EXPECT_EQ(cdk::string(L"k\u00e9y"), checker.m_key);
+    EXPECT_EQ(cdk::string("a\"b\\c\nd\xc4\x85\xf0\x9f\x98\x80 \xc5\x9b"),
+              checker.m_val);
+  }
+
+  {
+    std::string doc = "{ arr: [1, [2, {}], {'x': null}], num: -42 }";
+    JSON_utf8_parser parser((cdk::bytes(doc)));
+    parser.process(checker);
+    EXPECT_EQ(cdk::string("num"), checker.m_key);
+    EXPECT_EQ(-42, checker.m_num);
+  }
+
+  // negative tests
+
+  const char *invalid[] =
+  {
+    "",
+    "  ",
+    "invalid",
+    "[1, 2]",
+    "{ foo: 123, invalid }",
+    "{ foo: 123 } extra",
+    "{ \"foo\": \"unterminated }",
+    "{ \"foo\": 123",
+    "{ \"foo\": [1, 2 }",
+    "{ \"foo\": 18446744073709551616 }",
+    "{ \"foo\": \"\\u12\" }",
+  };
+
+  for (unsigned i=0; i < sizeof(invalid)/sizeof(char*); i++)
+  {
+    std::string doc = invalid[i];
+    JSON_utf8_parser parser((cdk::bytes(doc)));
+    EXPECT_THROW(parser.process(checker),cdk::Error) << "doc: " << doc;
+  }
+
+}
+
+
 class Expr_printer
   : public cdk::Expression::Processor
 {
@@ -651,6 +754,71 @@ TEST(Parser, expr)
 }
 
 
+TEST(Parser, tokenizer)
+{
+  struct Tok_test
+  {
+    Token::TokenType type;
+    const char *text;
+  }
+  expected[] = {
+    { Token::ID,        "Select" },
+    { Token::AND,       "aNd" },
+    { Token::MICROSECOND, "MicroSecond" },
+    { Token::INTEGER,   "Int" },
+    { Token::DATETIME,  "DATETIME" },
+    { Token::IS,        "is" },
+    { Token::ID,        "int1" },
+    { Token::ID,        "foo_bar" },
+    { Token::QUOTED_ID, "a`b" },
+    { Token::LSTRING,   "it's" },
+    { Token::LSTRING,   "x\"y" },
+    { Token::LSTRING,   "plain" },
+    { Token::LHEX,      "4a" },
+    { Token::LHEX,      "4b" },
+    { Token::LINTEGER,  "12" },
+    { Token::LNUM,      "1.5e3" },
+    { Token::LE,        "<=" },
+    { Token::ARROW,     "->" },
+    { Token::COLON,     ":" },
+  };
+
+  std::unique_ptr<Tokenizer> toks(new Tokenizer(
+    "Select aNd MicroSecond Int DATETIME is int1 foo_bar"
+    " `a``b` 'it''s' \"x\\\"y\" 'plain' X'4a' 0x4b 12 1.5e3 <= -> :"
+  ));
+  toks->get_tokens();
+
+  auto check = [&expected](const Tokenizer &tokenizer)
+  {
+    size_t pos = 0;
+    for (auto it = tokenizer.begin(); it != tokenizer.end(); ++it, ++pos)
+    {
+      ASSERT_LT(pos, sizeof(expected)/sizeof(Tok_test));
+      cout << Token::get_name(it->get_type()) << ": " << it->get_text() << endl;
+      EXPECT_EQ(expected[pos].type, it->get_type());
+      EXPECT_EQ(std::string(expected[pos].text), it->get_text());
+    }
+    EXPECT_EQ(sizeof(expected)/sizeof(Tok_test), pos);
+  };
+
+  check(*toks);
+
+  // Tokens of a copy must not refer to the original tokenizer.
+
+  Tokenizer copy(*toks);
+  toks.reset();
+
+  cout << "-- copy --" << endl;
+  check(copy);
+
+  EXPECT_TRUE(Token(Token::AND, "and", 3).is_reserved_word());
+  EXPECT_TRUE(Token(Token::INTEGER, "int", 3).is_reserved_word());
+  EXPECT_FALSE(Token(Token::ID, "foo", 3).is_reserved_word());
+  EXPECT_FALSE(Token(Token::PLUS, "+", 1).is_reserved_word());
+}
+
+
 const Expr_Test order_exprs[] =
 {
   { parser::Parser_mode::DOCUMENT, L"$.age"},
@@ -1250,6 +1418,9 @@ TEST(Parser, uri)
                 "a", "['a','b','c']",
                 "b", "valB",
                 "c", NULL,
+                NULL),
+    Query_test("socket=/tmp/mysqlx.sock",
+                "socket", "/tmp/mysqlx.sock",
                 NULL)
   };
 
@@ -52,69 +52,199 @@ POP_SYS_WARNINGS
 using namespace parser;
 using cdk::foundation::Error;
 
+/*
+  Keywords
+  ========
+
+  Keywords are recognized using a constant table of keywords and
+  a perfect hash function which maps each keyword to a different slot
+  of a hash table. The hash function looks at the length of a word and
+  at its first, second and last character -- it is case insensitive
+  because all characters are converted to lower case by setting bit 0x20
+  (for characters that can appear in identifiers, this changes only upper
+  case letters). Table `slots` which maps hash values to positions in the
+  keyword table, as well as table `reserved` which tells which token types
+  are keywords, are generated at compile time.
+
+  If the keyword list is changed, the hash function might no longer be
+  perfect, which is detected by the static assertion below. In that case
+  coefficients used by kw_hash() must be adjusted.
+*/
+
+namespace {
+
+struct Keyword
+{
+  const char *name;
+  size_t      len;
+  Token::TokenType type;
+};
+
+#define KEYWORD(W,T) { W, sizeof(W) - 1, Token::T }
+
+constexpr Keyword keywords[] =
+{
+  KEYWORD("and", AND),
+  KEYWORD("or", OR),
+  KEYWORD("xor", XOR),
+  KEYWORD("is", IS),
+  KEYWORD("not", NOT),
+  KEYWORD("like", LIKE),
+  KEYWORD("in", IN_),
+  KEYWORD("regexp", REGEXP),
+  KEYWORD("between", BETWEEN),
+  KEYWORD("interval", INTERVAL),
+  KEYWORD("escape", ESCAPE),
+  KEYWORD("div", DIV),
+  KEYWORD("hex", HEX),
+  KEYWORD("bin", BIN),
+  KEYWORD("true", TRUE_),
+  KEYWORD("false", FALSE_),
+  KEYWORD("null", T_NULL),
+  KEYWORD("second", SECOND),
+  KEYWORD("minute", MINUTE),
+  KEYWORD("hour", HOUR),
+  KEYWORD("day", DAY),
+  KEYWORD("week", WEEK),
+  KEYWORD("month", MONTH),
+  KEYWORD("quarter", QUARTER),
+  KEYWORD("year", YEAR),
+  KEYWORD("microsecond", MICROSECOND),
+  KEYWORD("as", AS),
+  KEYWORD("asc", ASC),
+  KEYWORD("desc", DESC),
+  KEYWORD("cast", CAST),
+  KEYWORD("character", CHARACTER),
+  KEYWORD("set", SET),
+  KEYWORD("charset", CHARSET),
+  KEYWORD("ascii", ASCII),
+  KEYWORD("unicode", UNICODE),
+  KEYWORD("byte", BYTE),
+  KEYWORD("binary", BINARY),
+  KEYWORD("char", CHAR),
+  KEYWORD("nchar", NCHAR),
+  KEYWORD("date", DATE),
+  KEYWORD("datetime", DATETIME),
+  KEYWORD("time", TIME),
+  KEYWORD("decimal", DECIMAL),
+  KEYWORD("signed", SIGNED),
+  KEYWORD("unsigned", UNSIGNED),
+  KEYWORD("integer", INTEGER),
+  KEYWORD("int", INTEGER),
+  KEYWORD("json", JSON),
+};
+
+constexpr size_t keyword_count = sizeof(keywords)/sizeof(Keyword);
+constexpr size_t slot_count = 128;
+
+#define token_count(T) +1
+constexpr size_t token_type_count = 0 TOKEN_LIST(token_count);
+
+
+constexpr size_t kw_hash(unsigned first, unsigned second, unsigned last,
+                         size_t len)
+{
+  return (3*first + 15*second + 35*last + 11*len) % slot_count;
+}
+
+constexpr size_t kw_hash(const Keyword &kw)
+{
+  return kw_hash((unsigned char)kw.name[0], (unsigned char)kw.name[1],
+                 (unsigned char)kw.name[kw.len - 1], kw.len);
+}
+
+// Position of the (first) keyword with given hash value, -1 if none.
+
+constexpr int kw_slot(size_t hash, size_t pos = 0)
+{
+  return pos >= keyword_count ? -1
+    : kw_hash(keywords[pos]) == hash ? (int)pos
+    : kw_slot(hash, pos + 1);
+}
+
+constexpr bool kw_is_reserved(size_t type, size_t pos = 0)
+{
+  return pos < keyword_count
+    && ((size_t)keywords[pos].type == type || kw_is_reserved(type, pos + 1));
+}
+
+constexpr bool kw_hash_is_perfect(size_t pos = 0)
+{
+  return pos >= keyword_count
+    || (kw_slot(kw_hash(keywords[pos])) == (int)pos
+        && kw_hash_is_perfect(pos + 1));
+}
+
+static_assert(kw_hash_is_perfect(), "Keyword hash function is not perfect");
+
+
+/*
+  Generating tables at compile time: Table<N>::slots[] and
+  Table<N>::reserved[] are initialized with values of kw_slot(I) and
+  kw_is_reserved(I) for I = 0,...,N-1, respectively.
+*/
+
+template <size_t... I> struct Index_list {};
+
+template <size_t N, size_t... I>
+struct Make_index_list : Make_index_list<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct Make_index_list<0, I...>
+{
+  typedef Index_list<I...> type;
+};
+
+template <class L> struct Kw_tables;
+
+template <size_t... I>
+struct Kw_tables< Index_list<I...> >
+{
+  static constexpr signed char slots[sizeof...(I)] = { kw_slot(I)... };
+  static constexpr bool reserved[sizeof...(I)] = { kw_is_reserved(I)... };
+};
+
+template <size_t... I>
+constexpr signed char Kw_tables< Index_list<I...> >::slots[sizeof...(I)];
+template <size_t... I>
+constexpr bool Kw_tables< Index_list<I...> >::reserved[sizeof...(I)];
+
+typedef Kw_tables<Make_index_list<slot_count>::type>       Slot_table;
+typedef Kw_tables<Make_index_list<token_type_count>::type> Type_table;
+
+
+/*
+  Return keyword token type for the given word or Token::ID if it is not
+  a keyword.
+*/
+
+Token::TokenType keyword_type(const char *word, size_t len)
+{
+  if (len < 2)
+    return Token::ID;
+
+  int pos = Slot_table::slots[
+    kw_hash((unsigned char)word[0] | 0x20, (unsigned char)word[1] | 0x20,
+            (unsigned char)word[len - 1] | 0x20, len)
+  ];
+
+  if (pos < 0 || keywords[pos].len != len)
+    return Token::ID;
+
+  for (size_t i = 0; i < len; ++i)
+    if (((unsigned char)word[i] | 0x20) != (unsigned char)keywords[pos].name[i])
+      return Token::ID;
+
+  return keywords[pos].type;
+}
+
+}  // anonymous namespace
+
+
 struct Tokenizer::Maps Tokenizer::map;
 
 Tokenizer::Maps::Maps()
 {
-  add_reserved_word("and", Token::AND);
-  add_reserved_word("or", Token::OR);
-  add_reserved_word("xor", Token::XOR);
-  add_reserved_word("is", Token::IS);
-  add_reserved_word("not", Token::NOT);
-  add_reserved_word("like", Token::LIKE);
-  add_reserved_word("in", Token::IN_);
-  add_reserved_word("regexp", Token::REGEXP);
-  add_reserved_word("between", Token::BETWEEN);
-  add_reserved_word("interval", Token::INTERVAL);
-  add_reserved_word("escape", Token::ESCAPE);
-  add_reserved_word("div", Token::DIV);
-  add_reserved_word("hex", Token::HEX);
-  add_reserved_word("bin", Token::BIN);
-  add_reserved_word("true", Token::TRUE_);
-  add_reserved_word("false", Token::FALSE_);
-  add_reserved_word("null", Token::T_NULL);
-  add_reserved_word("second", Token::SECOND);
-  add_reserved_word("minute", Token::MINUTE);
-  add_reserved_word("hour", Token::HOUR);
-  add_reserved_word("day", Token::DAY);
-  add_reserved_word("week", Token::WEEK);
-  add_reserved_word("month", Token::MONTH);
-  add_reserved_word("quarter", Token::QUARTER);
-  add_reserved_word("year", Token::YEAR);
-  add_reserved_word("microsecond", Token::MICROSECOND);
-  add_reserved_word("as", Token::AS);
-  add_reserved_word("asc", Token::ASC);
-  add_reserved_word("desc", Token::DESC);
-  add_reserved_word("cast", Token::CAST);
-  add_reserved_word("character", Token::CHARACTER);
-  add_reserved_word("set", Token::SET);
-  add_reserved_word("charset", Token::CHARSET);
-  add_reserved_word("ascii", Token::ASCII);
-  add_reserved_word("unicode", Token::UNICODE);
-  add_reserved_word("byte", Token::BYTE);
-  add_reserved_word("binary", Token::BINARY);
-  add_reserved_word("char", Token::CHAR);
-  add_reserved_word("nchar", Token::NCHAR);
-  add_reserved_word("date", Token::DATE);
-  add_reserved_word("datetime", Token::DATETIME);
-  add_reserved_word("time", Token::TIME);
-  add_reserved_word("decimal", Token::DECIMAL);
-  add_reserved_word("signed", Token::SIGNED);
-  add_reserved_word("unsigned", Token::UNSIGNED);
-  add_reserved_word("integer", Token::INTEGER);
-  add_reserved_word("int", Token::INTEGER);
-  add_reserved_word("json", Token::JSON);
-
-  interval_units.insert(Token::MICROSECOND);
-  interval_units.insert(Token::SECOND);
-  interval_units.insert(Token::MINUTE);
-  interval_units.insert(Token::HOUR);
-  interval_units.insert(Token::DAY);
-  interval_units.insert(Token::WEEK);
-  interval_units.insert(Token::MONTH);
-  interval_units.insert(Token::QUARTER);
-  interval_units.insert(Token::YEAR);
-
   operator_names["="] = "==";
   operator_names["and"] = "&&";
   operator_names["or"] = "||";
@@ -150,13 +280,14 @@ Tokenizer::Maps::Maps()
 }
 
 
-Token::Token(Token::TokenType type, const std::string& text) : _type(type), _text(text)
+Token::Token(Token::TokenType type, const char *text, size_t len)
+  : _type(type), _text(text), _len(len)
 {
 }
 
-const std::string& Token::get_text() const
+std::string Token::get_text() const
 {
-  return _text;
+  return std::string(_text, _len);
 }
 
 Token::TokenType Token::get_type() const
@@ -164,11 +295,9 @@ Token::TokenType Token::get_type() const
   return _type;
 }
 
-struct Tokenizer::Maps map;
-
 bool Token::is_reserved_word() const
 {
-  return map.reserved_word_types.end() != map.reserved_word_types.find(_type);
+  return Type_table::reserved[_type];
 }
 
 Tokenizer::Tokenizer(const std::string& input) : _input(input)
@@ -176,6 +305,13 @@ Tokenizer::Tokenizer(const std::string& input) : _input(input)
   _pos = 0;
 }
 
+Tokenizer::Tokenizer(const Tokenizer &other)
+  : _input(other._input), _pos(other._pos)
+{
+  if (!other._tokens.empty())
+    get_tokens();
+}
+
 bool Tokenizer::next_char_is(tokens_t::size_type i, int tok)
 {
   return (i + 1) < _input.size() && _input[i + 1] == tok;
@@ -205,11 +341,10 @@ bool Tokenizer::pos_token_type_is(tokens_t::size_type pos, Token::TokenType type
   return (pos < _tokens.size()) && (_tokens[pos].get_type() == type);
 }
 
-const std::string& Tokenizer::consume_token(Token::TokenType type)
+std::string Tokenizer::consume_token(Token::TokenType type)
 {
   assert_cur_token(type);
-  const std::string& v = _tokens[_pos++].get_text();
-  return v;
+  return _tokens[_pos++].get_text();
 }
 
 const Token& Tokenizer::peek_token()
@@ -322,21 +457,22 @@ bool Tokenizer::parse_float_expo(size_t& i)
 
 bool Tokenizer::parse_hex(size_t& i)
 {
-  std::string val;
+  size_t start = 0;
+  size_t len = 0;
   bool has_value = false;
 
   if((_input[i] == 'X' || _input[i] == 'x') && next_char_is(i, '\''))
   {
     i+=2;
 
-    size_t start = i;
+    start = i;
 
     for (; i < _input.size();++i)
     {
       if (_input[i] == '\'')
       {
-        // We don't want the 'either (so the -2)
-        val.assign(_input, start, i-2);
+        // We don't want the closing '
+        len = i - start;
 
         has_value = true;
         break;
@@ -347,14 +483,14 @@ bool Tokenizer::parse_hex(size_t& i)
   {
     i+=2;
 
-    size_t start = i;
+    start = i;
 
     for (; i < _input.size() && std::isalnum(_input[i]);++i)
     {}
 
-   --i;
+    len = i - start;
 
-    val.assign(_input, start, i-1);
+   --i;
 
     has_value = true;
 
@@ -362,7 +498,7 @@ bool Tokenizer::parse_hex(size_t& i)
 
   if (has_value)
   {
-    _tokens.push_back(Token(Token::LHEX, val));
+    add_token(Token::LHEX, start, len);
 
     return true;
   }
@@ -372,6 +508,9 @@ bool Tokenizer::parse_hex(size_t& i)
 
 void Tokenizer::get_tokens()
 {
+  _tokens.clear();
+  _unescaped.clear();
+
   for (size_t i = 0; i < _input.size(); ++i)
   {
     char c = _input[i];
@@ -392,7 +531,7 @@ void Tokenizer::get_tokens()
     size_t j=i;
     if (Token::T_NULL != (tt = parse_number(j)))
     {
-      _tokens.push_back(Token(tt, std::string(_input, i, j-i)));
+      add_token(tt, i, j-i);
       i = j-1;
       continue;
     }
@@ -402,146 +541,146 @@ void Tokenizer::get_tokens()
       // # non-identifier, e.g. operator or quoted literal
       if (c == '?')
       {
-        _tokens.push_back(Token(Token::PLACEHOLDER, std::string(1, c)));
+        add_token(Token::PLACEHOLDER, i, 1);
       }
       else if (c == '+')
       {
-        _tokens.push_back(Token(Token::PLUS, std::string(1, c)));
+        add_token(Token::PLUS, i, 1);
       }
       else if (c == '-')
       {
         if (next_char_is(i, '>'))
         {
+          add_token(Token::ARROW, i, 2);
           ++i;
-          _tokens.push_back(Token(Token::ARROW, "->"));
         }
         else
-        _tokens.push_back(Token(Token::MINUS, std::string(1, c)));
+        add_token(Token::MINUS, i, 1);
       }
       else if (c == '*')
       {
         if (next_char_is(i, '*'))
         {
+          add_token(Token::DOUBLESTAR, i, 2);
           ++i;
-          _tokens.push_back(Token(Token::DOUBLESTAR, std::string("**")));
         }
         else
         {
-          _tokens.push_back(Token(Token::MUL, std::string(1, c)));
+          add_token(Token::MUL, i, 1);
         }
       }
       else if (c == '/')
       {
-        _tokens.push_back(Token(Token::DIV, std::string(1, c)));
+        add_token(Token::DIV, i, 1);
       }
       else if (c == '$')
       {
-        _tokens.push_back(Token(Token::DOLLAR, std::string(1, c)));
+        add_token(Token::DOLLAR, i, 1);
       }
       else if (c == '%')
       {
-        _tokens.push_back(Token(Token::MOD, std::string(1, c)));
+        add_token(Token::MOD, i, 1);
       }
       else if (c == '=')
       {
-        _tokens.push_back(Token(Token::EQ, std::string(1, c)));
+        add_token(Token::EQ, i, 1);
       }
       else if (c == '&')
       {
-        _tokens.push_back(Token(Token::BITAND, std::string(1, c)));
+        add_token(Token::BITAND, i, 1);
       }
       else if (c == '|')
       {
-        _tokens.push_back(Token(Token::BITOR, std::string(1, c)));
+        add_token(Token::BITOR, i, 1);
       }
       else if (c == '^')
       {
-        _tokens.push_back(Token(Token::BITXOR, std::string(1, c)));
+        add_token(Token::BITXOR, i, 1);
       }
       else if (c == '(')
       {
-        _tokens.push_back(Token(Token::LPAREN, std::string(1, c)));
+        add_token(Token::LPAREN, i, 1);
       }
       else if (c == ')')
       {
-        _tokens.push_back(Token(Token::RPAREN, std::string(1, c)));
+        add_token(Token::RPAREN, i, 1);
       }
       else if (c == '[')
       {
-        _tokens.push_back(Token(Token::LSQBRACKET, std::string(1, c)));
+        add_token(Token::LSQBRACKET, i, 1);
       }
       else if (c == ']')
       {
-        _tokens.push_back(Token(Token::RSQBRACKET, std::string(1, c)));
+        add_token(Token::RSQBRACKET, i, 1);
       }
       else if (c == '{')
       {
-        _tokens.push_back(Token(Token::LCURLY, std::string(1, c)));
+        add_token(Token::LCURLY, i, 1);
       }
       else if (c == '}')
       {
-        _tokens.push_back(Token(Token::RCURLY, std::string(1, c)));
+        add_token(Token::RCURLY, i, 1);
       }
       else if (c == '~')
       {
-        _tokens.push_back(Token(Token::NEG, std::string(1, c)));
+        add_token(Token::NEG, i, 1);
       }
       else if (c == ',')
       {
-        _tokens.push_back(Token(Token::COMMA, std::string(1, c)));
+        add_token(Token::COMMA, i, 1);
       }
       else if (c == ':')
       {
-        _tokens.push_back(Token(Token::COLON, std::string(1, c)));
+        add_token(Token::COLON, i, 1);
       }
 //      else if (c == ';')
 //      {
-//        _tokens.push_back(Token(Token::SEMICOLON, std::string(1, c)));
+//        add_token(Token::SEMICOLON, i, 1);
 //      }
       else if (c == '!')
       {
         if (next_char_is(i, '='))
         {
+          add_token(Token::NE, i, 2);
           ++i;
-          _tokens.push_back(Token(Token::NE, std::string("!=")));
         }
         else
         {
-          _tokens.push_back(Token(Token::BANG, std::string(1, c)));
+          add_token(Token::BANG, i, 1);
         }
       }
       else if (c == '<')
       {
         if (next_char_is(i, '<'))
         {
+          add_token(Token::LSHIFT, i, 2);
           ++i;
-          _tokens.push_back(Token(Token::LSHIFT, std::string("<<")));
         }
         else if (next_char_is(i, '='))
         {
+          add_token(Token::LE, i, 2);
           ++i;
-          _tokens.push_back(Token(Token::LE, std::string("<=")));
         }
         else
         {
-          _tokens.push_back(Token(Token::LT, std::string("<")));
+          add_token(Token::LT, i, 1);
         }
       }
       else if (c == '>')
       {
         if (next_char_is(i, '>'))
         {
+          add_token(Token::RSHIFT, i, 2);
           ++i;
-          _tokens.push_back(Token(Token::RSHIFT, std::string(">>")));
         }
         else if (next_char_is(i, '='))
         {
+          add_token(Token::GE, i, 2);
           ++i;
-          _tokens.push_back(Token(Token::GE, std::string(">=")));
         }
         else
         {
-          _tokens.push_back(Token(Token::GT, std::string(1, c)));
+          add_token(Token::GT, i, 1);
         }
       }
       else if (c == '.')
@@ -556,20 +695,20 @@ void Tokenizer::get_tokens()
           // expo -> 'E' | 'e'
           // sign -> '-' | '+'
           parse_float_expo(i);
-          _tokens.push_back(Token(Token::LNUM, std::string(_input, start, i - start)));
+          add_token(Token::LNUM, start, i - start);
 
           if (i < _input.size())
             --i;
         }
         else
         {
-          _tokens.push_back(Token(Token::DOT, std::string(1, c)));
+          add_token(Token::DOT, i, 1);
         }
       }
       else if (c == '"' || c == '\'' || c == '`')
       {
         char quote_char = c;
-        std::string val;
+        bool escapes = false;
         size_t start = ++i;
 
         while (i < _input.size())
@@ -586,24 +725,48 @@ void Tokenizer::get_tokens()
             // this quote char has to be doubled
             if ((i + 1) >= _input.size())
               break;
-            val.append(1, _input[++i]);
+            escapes = true;
+            ++i;
           }
-          else
-            val.append(1, c);
           ++i;
         }
         if ((i >= _input.size()) && (_input[i] != quote_char))
         {
           throw Error((boost::format("Unterminated quoted string starting at %d") % start).str());
         }
-        if (quote_char == '`')
+
+        Token::TokenType type
+          = (quote_char == '`' ? Token::QUOTED_ID : Token::LSTRING);
+
+        if (!escapes)
         {
-          _tokens.push_back(Token(Token::QUOTED_ID, val));
+          add_token(type, start, i - start);
+          continue;
         }
-        else
+
+        /*
+          String contains escaped characters -- its value is stored in
+          _unescaped buffer. Since unescaped strings are never longer than
+          the input, reserving input size guarantees that the buffer is not
+          re-allocated (which would invalidate tokens referring to it).
+        */
+
+        if (_unescaped.empty())
+          _unescaped.reserve(_input.size());
+
+        size_t pos = _unescaped.size();
+
+        for (size_t k = start; k < i; ++k)
         {
-          _tokens.push_back(Token(Token::LSTRING, val));
+          c = _input[k];
+          if ((c == quote_char) || (c == '\\'  && quote_char != '`'))
+            c = _input[++k];
+          _unescaped.push_back(c);
         }
+
+        _tokens.push_back(
+          Token(type, _unescaped.data() + pos, _unescaped.size() - pos)
+        );
       }
       else
       {
@@ -615,16 +778,8 @@ void Tokenizer::get_tokens()
       size_t start = i;
       while (i < _input.size() && (std::isalnum(_input[i]) || _input[i] == '_'))
         ++i;
-      std::string val(_input, start, i - start);
-      Maps::reserved_words_t::const_iterator it = map.reserved_words.find(val);
-      if (it != map.reserved_words.end())
-      {
-        _tokens.push_back(Token(it->second, val));
-      }
-      else
-      {
-        _tokens.push_back(Token(Token::ID, val));
-      }
+      add_token(keyword_type(_input.data() + start, i - start),
+                start, i - start);
       --i;
     }
   }
@@ -663,8 +818,21 @@ bool Tokenizer::tokens_available()
 bool Tokenizer::is_interval_units_type()
 {
   assert_tok_position();
-  Token::TokenType type = _tokens[_pos].get_type();
-  return map.interval_units.find(type) != map.interval_units.end();
+  switch (_tokens[_pos].get_type())
+  {
+  case Token::MICROSECOND:
+  case Token::SECOND:
+  case Token::MINUTE:
+  case Token::HOUR:
+  case Token::DAY:
+  case Token::WEEK:
+  case Token::MONTH:
+  case Token::QUARTER:
+  case Token::YEAR:
+    return true;
+  default:
+    return false;
+  }
 }
 
 bool Tokenizer::is_type_within_set(const std::set<Token::TokenType>& types)
@@ -127,6 +127,13 @@ namespace parser {
     X(RCURLY) \
     X(ARROW)\
 
+  /*
+    Token does not own its text: it refers to a fragment of the input
+    string stored in the Tokenizer which created it (or to the Tokenizer's
+    buffer with unescaped text of quoted strings). Therefore a token can
+    be used only as long as its tokenizer exists.
+  */
+
   class Token
   {
   public:
@@ -138,9 +145,8 @@ namespace parser {
       TOKEN_LIST(token_enum)
     };
 
-    Token(TokenType type, const std::string& text);
-    // TODO: it is better if this one returns a pointer (std::string*)
-    const std::string& get_text() const;
+    Token(TokenType type, const char *text, size_t len);
+    std::string get_text() const;
     TokenType get_type() const;
     bool is_reserved_word() const;
 
@@ -162,7 +168,8 @@ namespace parser {
 
   private:
     TokenType _type;
-    std::string _text;
+    const char *_text;
+    size_t _len;
   };
 
 
@@ -173,6 +180,14 @@ namespace parser {
   public:
     Tokenizer(const std::string& input);
 
+    /*
+      Tokens refer to the text stored in the tokenizer, so a copy of the
+      tokenizer must create its own tokens.
+    */
+
+    Tokenizer(const Tokenizer&);
+    Tokenizer& operator=(const Tokenizer&) = delete;
+
     typedef std::vector<Token> tokens_t;
     typedef tokens_t::const_iterator  iterator;
 
@@ -181,7 +196,7 @@ namespace parser {
     bool cur_token_type_is(Token::TokenType type);
     bool next_token_type(Token::TokenType type);
     bool pos_token_type_is(tokens_t::size_type pos, Token::TokenType type);
-    const std::string& consume_token(Token::TokenType type);
+    std::string consume_token(Token::TokenType type);
     const Token& peek_token();
     void unget_token();
     void inc_pos_token();
@@ -201,8 +216,14 @@ namespace parser {
   protected:
     std::vector<Token> _tokens;
     std::string _input;
+    std::string _unescaped;
     tokens_t::size_type _pos;
 
+    void add_token(Token::TokenType type, size_t pos, size_t len)
+    {
+      _tokens.push_back(Token(type, _input.data() + pos, len));
+    }
+
     Token::TokenType parse_number(size_t& i);
     bool parse_float_expo(size_t& i);
     bool parse_hex(size_t& i);
@@ -214,25 +235,18 @@ namespace parser {
       bool operator()(const std::string& lhs, const std::string& rhs) const;
     };
 
+    /*
+      Note: Keywords are not stored here -- they are recognized using
+      a constant table defined in tokenizer.cc.
+    */
+
     struct Maps
     {
     public:
-      typedef std::map<std::string, Token::TokenType, Cmp_icase> reserved_words_t;
-      reserved_words_t reserved_words;
-      std::set<Token::TokenType> reserved_word_types;
-      std::set<Token::TokenType> interval_units;
       std::map<std::string, std::string, Cmp_icase> operator_names;
       std::map<std::string, std::string, Cmp_icase> unary_operator_names;
 
       Maps();
-
-    private:
-
-      void add_reserved_word(const char *word, Token::TokenType type)
-      {
-        reserved_words[word] = type;
-        reserved_word_types.insert(type);
-      }
     };
 
   public:
@@ -472,7 +472,8 @@ void set_find(Mysqlx::Crud::Find &msg,
 Protocol::Op&
 Protocol::snd_Find(Data_model dm, const Find_spec &fs, const api::Args_map *args)
 {
-  Mysqlx::Crud::Find find;
+  Mysqlx::Crud::Find &find
+    = get_impl().get_snd_msg<Mysqlx::Crud::Find>(msg_type::cli_CrudFind);
 
   set_find(find, dm, fs, args);
 
@@ -543,7 +544,8 @@ Protocol::snd_Insert(
     Row_source &rs,
     const api::Args_map *args)
 {
-  Mysqlx::Crud::Insert insert;
+  Mysqlx::Crud::Insert &insert
+    = get_impl().get_snd_msg<Mysqlx::Crud::Insert>(msg_type::cli_CrudInsert);
 
   Placeholder_conv_imp conv;
 
@@ -651,7 +653,8 @@ Protocol::Op& Protocol::snd_Update(
     Update_spec &us,
     const api::Args_map *args)
 {
-  Mysqlx::Crud::Update update;
+  Mysqlx::Crud::Update &update
+    = get_impl().get_snd_msg<Mysqlx::Crud::Update>(msg_type::cli_CrudUpdate);
   Placeholder_conv_imp conv;
 
   set_data_model(dm, update);
@@ -677,7 +680,8 @@ Protocol::Op& Protocol::snd_Update(
 Protocol::Op&
 Protocol::snd_Delete(Data_model dm, const Select_spec &sel, const api::Args_map *args)
 {
-  Mysqlx::Crud::Delete del;
+  Mysqlx::Crud::Delete &del
+    = get_impl().get_snd_msg<Mysqlx::Crud::Delete>(msg_type::cli_CrudDelete);
   Placeholder_conv_imp conv;
 
   set_data_model(dm, del);
@@ -135,7 +135,11 @@ static void log_handler_init()
 Protocol_impl::Protocol_impl(Protocol::Stream *str, Protocol_side side)
   : m_str(str), m_side(side)
   , m_msg_state(PAYLOAD)
+  , m_ahead_pos(0), m_ahead_end(0)
+  , m_rd_need(0), m_rd_direct(false)
   , m_msg_size(0)
+  , m_wr_pipeline(false)
+  , m_wr_pending(0)
 {
   EXECUTE_ONCE(&log_handler_once, &log_handler_init);
 
@@ -144,8 +148,9 @@ Protocol_impl::Protocol_impl(Protocol::Stream *str, Protocol_side side)
   m_wr_size= m_rd_size= 512;
   m_rd_buf= (byte*)malloc(m_rd_size);
   m_wr_buf= (byte*)malloc(m_wr_size);
+  m_ahead_buf= (byte*)malloc(rd_ahead_size);
 
-  if (!m_rd_buf)
+  if (!m_rd_buf || !m_ahead_buf)
     throw_error("Could not allocate initial input buffer");
 
   if (!m_wr_buf)
@@ -156,6 +161,7 @@ Protocol_impl::~Protocol_impl()
 {
   free(m_rd_buf);
   free(m_wr_buf);
+  free(m_ahead_buf);
   delete m_str;
 }
 
@@ -300,18 +306,30 @@ static void log_handler(LogLevel level, const char* filename, int line, const st
 void Protocol_impl::write_msg(msg_type_t msg_type, Message &msg)
 {
   if (m_wr_op)
-    THROW("Can't write message while another one is written");
+  {
+    if (!m_wr_pipeline)
+      THROW("Can't write message while another one is written");
+
+    // Output buffer can be re-used only after previous write completes.
+
+    wr_wait();
+  }
 
+  // In pipelined mode, new frame is appended after pending ones.
+
+  size_t offset = m_wr_pending;
   msg_size_t net_size = static_cast<unsigned>(msg.ByteSize()) + 1;
 
-  if (!resize_buf(CLIENT, header_length + net_size))
+  if (!resize_buf(CLIENT, offset + header_length + net_size))
     THROW("Not enough memory for output buffer");
 
+  byte *frame = m_wr_buf + offset;
+
   // Construct message header
 
   HTONSIZE(net_size);
-  memcpy((void*)m_wr_buf, (const void*)&net_size, sizeof(net_size));
-  m_wr_buf[header_length - 1] = (byte)msg_type;
+  memcpy((void*)frame, (const void*)&net_size, sizeof(net_size));
+  frame[header_length - 1] = (byte)msg_type;
 
   // Convert net_size back to original endian before using it later
 
@@ -321,13 +339,21 @@ void Protocol_impl::write_msg(msg_type_t msg_type, Message &msg)
 
   assert(m_wr_size < (size_t)std::numeric_limits<int>::max());
 
-  if (!msg.SerializeToArray((void*)(m_wr_buf + header_length),
-                            (int)(m_wr_size - header_length)))
+  if (!msg.SerializeToArray((void*)(frame + header_length),
+                            (int)(m_wr_size - offset - header_length)))
     throw_error(cdkerrc::protobuf_error, "Serialization error!");
 
+  size_t frame_size = net_size + header_length - 1;
+
+  if (m_wr_pipeline)
+  {
+    m_wr_pending += frame_size;
+    return;
+  }
+
   // Create write operation to send message payload
 
-  m_wr_op.reset(m_str->write(buffers(m_wr_buf, net_size + header_length - 1)));
+  m_wr_op.reset(m_str->write(buffers(m_wr_buf, frame_size)));
 }
 
 
@@ -354,15 +380,46 @@ void Protocol_impl::wr_wait()
 }
 
 
+/*
+  Send the first len bytes of pipelined messages in a single write and
+  move the remaining ones to the beginning of the output buffer. This is
+  a blocking operation - it returns only after the bytes are written.
+*/
+
+void Protocol_impl::wr_flush(size_t len)
+{
+  if (len > m_wr_pending)
+    len = m_wr_pending;
+
+  if (0 == len)
+    return;
+
+  wr_wait();
+  m_wr_op.reset(m_str->write(buffers(m_wr_buf, len)));
+  wr_wait();
+
+  m_wr_pending -= len;
+  memmove(m_wr_buf, m_wr_buf + len, m_wr_pending);
+}
+
+
+void Protocol_impl::set_pipeline(bool on)
+{
+  if (!on)
+    wr_flush(m_wr_pending);
+  m_wr_pipeline = on;
+}
+
+
 void Protocol_impl::read_header()
 {
   if (HEADER == m_msg_state)
     return;
 
-  if (m_rd_op)
+  if (m_rd_op || m_rd_need > 0)
     THROW("can't read header when reading payload is not completed");
 
-  m_rd_op.reset(m_str->read(buffers(m_rd_buf,4)));
+  m_rd_need= header_length;
   m_msg_state= HEADER;
 }
 
@@ -374,49 +431,133 @@ void Protocol_impl::read_payload()
   if (HEADER != m_msg_state)
     THROW("payload can be read only after header");
 
-  if (m_rd_op)
+  if (m_rd_op || m_rd_need > 0)
     THROW("can't read payload when reading header is not completed");
 
   if (!resize_buf(SERVER, m_msg_size))
       THROW("Not enough memory for input buffer");
 
-  if (m_msg_size > 0)
-    m_rd_op.reset(m_str->read(buffers(m_rd_buf, m_msg_size)));
+  m_rd_need= m_msg_size;
   m_msg_state= PAYLOAD;
 }
 
 
 bool Protocol_impl::rd_cont()
 {
-  if (!m_rd_op)
-    return true;
+  return rd_fill(false);
+}
 
-  if (!m_rd_op->cont())
-    return false;
 
-  m_rd_op.reset();
+void Protocol_impl::rd_wait()
+{
+  rd_fill(true);
+}
 
-  if (PAYLOAD == m_msg_state)
-    return true;
 
-  rd_process();
+/*
+  Drive reading of the current header or payload, taking bytes from
+  the read-ahead buffer and reading more bytes from the stream when
+  needed. If wait is false, returns false when the read can not be completed
+  without waiting for more data. Returns true once the header or payload
+  is read.
+*/
+
+bool Protocol_impl::rd_fill(bool wait)
+{
+  while (m_rd_need > 0)
+  {
+    // Complete pending read operation, if any.
+
+    if (m_rd_op)
+    {
+      if (wait)
+        m_rd_op->wait();
+      else if (!m_rd_op->cont())
+        return false;
+
+      size_t howmuch= m_rd_op->get_result();
+      m_rd_op.reset();
+
+      if (m_rd_direct)
+      {
+        // The remainder of the payload was read directly into m_rd_buf.
+        m_rd_direct= false;
+        m_rd_need= 0;
+        break;
+      }
+
+      m_ahead_end += howmuch;
+
+      if (0 == howmuch && !wait)
+        return false;
+    }
+
+    // Take as many bytes from the read-ahead buffer as possible.
+
+    size_t avail= m_ahead_end - m_ahead_pos;
+
+    if (HEADER == m_msg_state)
+    {
+      if (avail >= header_length)
+      {
+        rd_process();
+        break;
+      }
+    }
+    else
+    {
+      size_t howmuch= avail < m_rd_need ? avail : m_rd_need;
+      memcpy(m_rd_buf + (m_msg_size - m_rd_need),
+             m_ahead_buf + m_ahead_pos, howmuch);
+      m_ahead_pos += howmuch;
+      m_rd_need -= howmuch;
+      if (0 == m_rd_need)
+        break;
+
+      // Big payloads are read directly into m_rd_buf.
+
+      if (m_rd_need >= rd_ahead_size)
+      {
+        m_rd_op.reset(m_str->read(
+          buffers(m_rd_buf + (m_msg_size - m_rd_need), m_rd_need)));
+        m_rd_direct= true;
+        continue;
+      }
+    }
+
+    /*
+      Not enough bytes in the buffer - move the remaining ones to the
+      beginning of the buffer and read more.
+    */
+
+    avail= m_ahead_end - m_ahead_pos;
+
+    if (m_ahead_pos > 0)
+    {
+      memmove(m_ahead_buf, m_ahead_buf + m_ahead_pos, avail);
+      m_ahead_pos= 0;
+      m_ahead_end= avail;
+    }
+
+    m_rd_op.reset(m_str->read_some(buffers(m_ahead_buf + m_ahead_end,
+                                           rd_ahead_size - m_ahead_end)));
+  }
 
   return true;
 }
 
 
-void Protocol_impl::rd_wait()
+Message& Protocol_impl::get_rcv_msg(msg_type_t type)
 {
-  if (m_rd_op)
-  {
-    m_rd_op->wait();
-    m_rd_op.reset();
+  if (type >= msg_cache_size)
+    THROW("unknown message type");
 
-    if (PAYLOAD == m_msg_state)
-      return;
+  scoped_ptr<Message> &msg = m_rcv_msgs[type];
 
-    rd_process();
-  }
+  if (!msg)
+    msg.reset(mk_message(m_side, type));
+
+  return *msg;
 }
 
 
@@ -455,15 +596,18 @@ bool Protocol_impl::resize_buf(Protocol_side side, size_t requested_size)
 
 void Protocol_impl::rd_process()
 {
-  m_msg_size= *(msg_size_t*)m_rd_buf;
-  NTOHSIZE(m_msg_size);
+  assert(m_ahead_end - m_ahead_pos >= header_length);
+
+  msg_size_t net_size;
+  memcpy(&net_size, m_ahead_buf + m_ahead_pos, sizeof(net_size));
+  NTOHSIZE(net_size);
+  m_msg_size= net_size;
   assert(m_msg_size > 0);
   m_msg_size--;
 
-  m_rd_op.reset(m_str->read(buffers(m_rd_buf, 1)));
-  m_rd_op->wait();
-  m_rd_op.reset();
-  m_msg_type= m_rd_buf[0];
+  m_msg_type= m_ahead_buf[m_ahead_pos + header_length - 1];
+  m_ahead_pos += header_length;
+  m_rd_need= 0;
 }
 
 
@@ -692,24 +836,34 @@ void Op_rcv::process_payload()
   if (m_skip)
     return;
 
-  // Parse message.
+  // See if message can be processed without parsing it.
+
+  try {
+    if (process_raw_msg(m_msg_type, bytes(m_proto.m_rd_buf, m_msg_size)))
+      return;
+  }
+  catch (...)
+  {
+    save_error();
+    return;
+  }
+
+  // Parse message into cached message object.
+
+  Message *msg = &m_proto.get_rcv_msg(m_msg_type);
 
-  scoped_ptr<Message> m_msg;
-  m_msg.reset(mk_message(m_proto.m_side, m_msg_type));
+  try {
+    assert(m_msg_size < (size_t)std::numeric_limits<int>::max());
 
-  if (m_msg_size > 0)
+    if (0 == m_msg_size)
+      msg->Clear();
+    else if (!msg->ParseFromArray(m_proto.m_rd_buf, (int)m_msg_size))
+      throw_error(cdkerrc::protobuf_error, "Message could not be parsed");
+  }
+  catch (...)
   {
-    try {
-      assert(m_msg_size < (size_t)std::numeric_limits<int>::max());
-      if (!m_msg->ParseFromArray(m_proto.m_rd_buf, (int)m_msg_size))
-        throw_error(cdkerrc::protobuf_error, "Message could not be parsed");
-    }
-    catch (...)
-    {
-      save_error();
-      m_msg.reset();
-      return;
-    }
+    save_error();
+    return;
   }
 
 #ifdef DEBUG_PROTOBUF
@@ -721,14 +875,14 @@ void Op_rcv::process_payload()
   cerr << "<<<< Received message <<<<" << endl;
   cerr << "of type " << m_msg_type <<": "
        << msg_type_name(SERVER, m_msg_type) << endl;
-  cerr << m_msg->DebugString();
+  cerr << msg->DebugString();
   cerr << "<<<<" << endl << endl;
 
 #endif
 
   // Pass data from parsed message to processor
 
-  process_msg(m_msg_type, *m_msg);
+  process_msg(m_msg_type, *msg);
 }
 
 
@@ -812,6 +966,21 @@ Protocol::Op& Protocol::snd_Close()
   return get_impl().snd_start(close, msg_type::cli_Close);
 }
 
+void Protocol::set_pipeline(bool on)
+{
+  get_impl().set_pipeline(on);
+}
+
+size_t Protocol::pipeline_pending() const
+{
+  return get_impl().pipeline_pending();
+}
+
+void Protocol::pipeline_flush(size_t len)
+{
+  get_impl().pipeline_flush(len);
+}
+
 Protocol::Op& Protocol::rcv_Reply(Reply_processor &prc)
 {
   return get_impl().rcv_start<Rcv_reply>(prc);
@@ -89,6 +89,12 @@ const size_t header_length= 5;
 const size_t max_wr_size= 1024*1024*1024;  // 1GB
 const size_t max_rd_size= max_wr_size;
 
+/// Size of the read-ahead buffer used to receive message frames.
+const size_t rd_ahead_size= 16*1024;
+
+/// Number of message types for which message objects are cached.
+const msg_type_t msg_cache_size= 64;
+
 // TODO: use throw_error or any other appropriate method when the code is ready
 #define THROW_PROTOCOL_ERROR(ERR) throw ERR
 
@@ -183,6 +189,22 @@ protected:
 
     To complete the asynchronous header/payload reading operation one has
     to call method rd_cont() until it returns true.
+
+    Bytes are not read from the stream frame by frame. Instead, read_some()
+    operations are used to fill the read-ahead buffer m_ahead_buf with as many
+    bytes as are available in the stream (up to rd_ahead_size). Headers and
+    payloads are then taken from this buffer so that a single read from the
+    stream can deliver many small messages. Bytes in the range
+    [m_ahead_pos, m_ahead_end) have been read but not yet consumed.
+
+    Only a payload which is too big to fit into the read-ahead buffer is read
+    directly into m_rd_buf, after its already buffered part has been copied
+    there (m_rd_direct is true while such read is in progress). The m_rd_need
+    member tells how many bytes are still missing to complete the current
+    header or payload read.
+
+    Note: Since bytes are read ahead, the protocol object assumes that nobody
+    else reads from the same stream.
   */
 
   enum { HEADER, PAYLOAD }   m_msg_state;
@@ -196,6 +218,14 @@ protected:
   size_t  m_rd_size;
   scoped_ptr<Protocol::Stream::Op> m_rd_op;
 
+  byte   *m_ahead_buf;
+  size_t  m_ahead_pos;
+  size_t  m_ahead_end;
+  size_t  m_rd_need;
+  bool    m_rd_direct;
+
+  bool rd_fill(bool wait);
+
   // Info extracted from message header
 
   msg_type_t m_msg_type;
@@ -211,18 +241,79 @@ protected:
 
     To complete writing operation one has to call method wr_cont() until it
     returns true.
+
+    If pipelining is enabled (m_wr_pipeline is true), write_msg() only
+    appends the message frame to the output buffer and no write operation
+    is started. Such pending output (first m_wr_pending bytes of m_wr_buf)
+    is sent by wr_flush(), which can send only a leading part of it. The
+    amount of output sent ahead of reading replies is controlled by the
+    user of the protocol object (see Protocol::pipeline_flush()).
   */
 
   void write_msg(msg_type_t, Message&);
   bool wr_cont();
   void wr_wait();
+  void wr_flush(size_t len);
 
   byte   *m_wr_buf;
   size_t  m_wr_size;
   scoped_ptr<Protocol::Stream::Op> m_wr_op;
 
+  bool    m_wr_pipeline;
+  size_t  m_wr_pending;
+
+public:
+
+  void set_pipeline(bool);
+  size_t pipeline_pending() const { return m_wr_pending; }
+  void pipeline_flush(size_t len) { wr_flush(len); }
+
+protected:
+
   bool resize_buf(Protocol_side side, size_t new_size);
 
+public:
+
+  /*
+    Message object cache
+    --------------------
+
+    Protobuf message objects used to parse incoming messages and to build
+    outgoing ones are not created anew for each message. Instead, a single
+    instance of each message type is kept in m_rcv_msgs/m_snd_msgs (indexed
+    by message type) and re-used after clearing it. Since protobuf Clear()
+    keeps memory allocated for strings and sub-messages, processing messages
+    in a steady state does not allocate memory.
+
+    Method get_rcv_msg() returns message object for parsing incoming message
+    of given type, which is not cleared (parsing clears it). Method
+    get_snd_msg<MSG>() returns empty message object of type MSG to be filled
+    and passed to snd_start() (which serializes it right away). It should
+    always be used with the same MSG type for given message type.
+  */
+
+  Message& get_rcv_msg(msg_type_t);
+
+  template <class MSG>
+  MSG& get_snd_msg(msg_type_t type)
+  {
+    assert(type < msg_cache_size);
+
+    scoped_ptr<Message> &msg = m_snd_msgs[type];
+
+    if (!msg)
+      msg.reset(new MSG());
+    else
+      msg->Clear();
+
+    return static_cast<MSG&>(*msg);
+  }
+
+private:
+
+  scoped_ptr<Message> m_rcv_msgs[msg_cache_size];
+  scoped_ptr<Message> m_snd_msgs[msg_cache_size];
+
 public:
 
   /**
@@ -545,6 +636,18 @@ protected:
   virtual void process_msg(msg_type_t, Message&);
   virtual void do_process_msg(msg_type_t, Message&) {}
 
+  /*
+    Process raw message payload without parsing it into a protobuf message
+    object. This is called before the payload is parsed. If it returns true,
+    the message is considered processed and process_msg() is not called for
+    it. By default it returns false and all messages are parsed.
+
+    Specializations can override it to implement fast paths for frequent
+    messages. The payload bytes are valid only until next message is read.
+  */
+
+  virtual bool process_raw_msg(msg_type_t, bytes) { return false; }
+
   /**
     This method is called after processing each message to determine
     if operation should continue processing next message or stop.
@@ -141,6 +141,17 @@ protected:
     throw_error("Invalid processor used to process server reply");
   }
 
+  /*
+    Row messages are decoded directly from the raw payload by
+    process_raw_msg() and process_row(), without creating protobuf
+    message object (see below). Method process_field() passes single
+    field of a row to the processor.
+  */
+
+  bool process_raw_msg(msg_type_t, bytes);
+  void process_row(bytes, Row_processor&);
+  void process_field(Row_processor&, col_count_t, bytes);
+
 };
 
 
@@ -563,25 +574,140 @@ void Rcv_result_base::process_msg_with(Mysqlx::Resultset::Row &row,
   for (RepeatedPtrField< ::std::string>::const_iterator it = row.field().begin();
         it != row.field().end(); ++it, ++ccount)
   {
+    process_field(rp, ccount, bytes((byte*)it->data(), it->length()));
+  }
+
+  rp.row_end(rcount);
+}
+
+
+void Rcv_result_base::process_field(Row_processor &rp, col_count_t ccount,
+                                    bytes data)
+{
+  if (data.size() == 0)
+  {
+    rp.col_null(ccount);
+    return;
+  }
+
+  size_t read_window = rp.col_begin(ccount, data.size());
+  size_t pos= 0;
+
+  while (data.size() > pos && read_window)
+  {
+    size_t bytes_to_feed = data.size() - pos > read_window ? read_window : data.size() - pos;
+    size_t read_window_new = rp.col_data(ccount, bytes(data.begin() + pos, bytes_to_feed));
+    pos += read_window;
+    read_window = read_window_new;
+  }
+
+  rp.col_end(ccount, data.size());
+}
+
+
+/*
+  Fast path for processing rows
+  -----------------------------
+
+  Row messages are the most frequent ones in server replies. Instead of
+  parsing them into Mysqlx::Resultset::Row object, which copies each field
+  into a separate std::string, fields are decoded directly from the message
+  payload and passed to the processor as slices of the input buffer.
+
+  Row message has single repeated field of type bytes. On the wire, each
+  value of this field is encoded as a varint tag (field number 1, wire type 2)
+  followed by varint length and field bytes. Other fields, if present, are
+  skipped.
+*/
+
+static uint64_t read_varint(const byte *&pos, const byte *end)
+{
+  uint64_t val= 0;
+
+  for (unsigned shift= 0; shift < 64; shift += 7)
+  {
+    if (pos >= end)
+      break;
+
+    byte b= *pos++;
+    val |= (uint64_t)(b & 0x7F) << shift;
+
+    if (!(b & 0x80))
+      return val;
+  }
 
-    if (it->length() == 0)
+  throw_error(cdkerrc::protobuf_error, "Message could not be parsed");
+  return 0;  // quiet compiler warnings
+}
+
+
+static void skip_field(unsigned wire_type, const byte *&pos, const byte *end)
+{
+  size_t len;
+
+  switch (wire_type)
+  {
+  case 0: read_varint(pos, end); return;
+  case 1: len= 8; break;
+  case 5: len= 4; break;
+  case 2:
     {
-      rp.col_null(ccount);
-      continue;
+      uint64_t l= read_varint(pos, end);
+      if (l > (uint64_t)(end - pos))
+        throw_error(cdkerrc::protobuf_error, "Message could not be parsed");
+      len= (size_t)l;
     }
+    break;
+  default:
+    throw_error(cdkerrc::protobuf_error, "Message could not be parsed");
+    return;
+  }
+
+  if (len > (size_t)(end - pos))
+    throw_error(cdkerrc::protobuf_error, "Message could not be parsed");
+  pos += len;
+}
+
+
+bool Rcv_result_base::process_raw_msg(msg_type_t type, bytes payload)
+{
+  if (ROWS != m_result_state || msg_type::Row != type)
+    return false;
 
-    size_t read_window = rp.col_begin(ccount, it->length());
-    size_t pos= 0;
+  process_row(payload, *static_cast<Row_processor*>(m_prc));
+  return true;
+}
+
+
+void Rcv_result_base::process_row(bytes payload, Row_processor &rp)
+{
+  row_count_t rcount= m_rcount++;
+
+  if(!rp.row_begin(rcount))
+    return; // skip this row if the processor doesn't want it
 
-    while (it->length() > pos && read_window)
+  const byte *pos= payload.begin();
+  const byte *end= payload.end();
+  col_count_t ccount = 0;
+
+  while (pos < end)
+  {
+    uint64_t tag= read_varint(pos, end);
+    unsigned wire_type= (unsigned)(tag & 0x7);
+
+    if (1 != (tag >> 3) || 2 != wire_type)
     {
-      size_t bytes_to_feed = it->length() - pos > read_window ? read_window : it->length() - pos;
-      size_t read_window_new = rp.col_data(ccount, bytes((byte*)(it->c_str() + pos), bytes_to_feed));
-      pos += read_window;
-      read_window = read_window_new;
+      skip_field(wire_type, pos, end);
+      continue;
     }
 
-    rp.col_end(ccount, it->length());
+    uint64_t len= read_varint(pos, end);
+
+    if (len > (uint64_t)(end - pos))
+      throw_error(cdkerrc::protobuf_error, "Message could not be parsed");
+
+    process_field(rp, ccount++, bytes((byte*)pos, (size_t)len));
+    pos += len;
   }
 
   rp.row_end(rcount);
@@ -114,6 +114,13 @@ Protocol::Op& Protocol::snd_AuthenticateContinue(bytes data)
 }
 
 
+Protocol::Op& Protocol::snd_SessionReset()
+{
+  Mysqlx::Session::Reset reset;
+  return get_impl().snd_start(reset, msg_type::cli_SessionReset);
+}
+
+
 class Rcv_auth_base : public Op_rcv
 {
 public:
@@ -74,7 +74,9 @@ Protocol::Op& Protocol::snd_StmtExecute(const char *ns,
                                         const string &stmt,
                                         const api::Any_list *args)
 {
-  Mysqlx::Sql::StmtExecute stmt_exec;
+  Mysqlx::Sql::StmtExecute &stmt_exec
+    = get_impl().get_snd_msg<Mysqlx::Sql::StmtExecute>(
+        msg_type::cli_StmtExecute);
 
   if (ns)
     stmt_exec.set_namespace_(ns);
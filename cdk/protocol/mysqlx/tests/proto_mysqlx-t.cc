@@ -100,3 +100,164 @@ TEST(Protocol_mysqlx, io_buffers)
   }
   CATCH_TEST_GENERIC;
 }
+
+
+/*
+  Several messages written to the stream before the other end starts
+  reading them. They should be received one by one in the same order even
+  though the receiving side reads ahead as many bytes as are available.
+  One of the messages does not fit into the read-ahead buffer.
+*/
+
+TEST(Protocol_mysqlx, read_ahead)
+{
+  typedef foundation::test::Mem_stream<1024*1024> Stream;
+
+  try {
+
+    scoped_ptr<Stream> conn(new Stream());
+
+    Protocol proto(*conn);
+    Protocol_server srv(*conn);
+
+    const unsigned msg_count = 100;
+    const size_t   big_size = 64*1024;
+
+    std::string big(big_size, 'x');
+
+    proto.snd_AuthenticateStart("test", bytes("start"), bytes("")).wait();
+
+    for (unsigned i = 0; i < msg_count; ++i)
+    {
+      if (msg_count/2 == i)
+        proto.snd_AuthenticateContinue(
+          bytes((byte*)big.data(), big.size())).wait();
+      else
+        proto.snd_AuthenticateContinue(bytes("continue")).wait();
+    }
+
+    struct : public Init_processor
+    {
+      unsigned starts;
+      unsigned conts;
+      size_t   big_size;
+
+      void auth_start(const char *mech, bytes data, bytes)
+      {
+        EXPECT_EQ(std::string("test"), std::string(mech));
+        EXPECT_EQ(5U, data.size());
+        starts++;
+      }
+
+      void auth_continue(bytes data)
+      {
+        if (data.size() != 8)
+        {
+          EXPECT_EQ(big_size, data.size());
+        }
+        conts++;
+      }
+
+    } prc;
+
+    prc.starts = 0;
+    prc.conts = 0;
+    prc.big_size = big_size;
+
+    for (unsigned i = 0; i <= msg_count; ++i)
+      srv.rcv_InitMessage(prc).wait();
+
+    EXPECT_EQ(1U, prc.starts);
+    EXPECT_EQ(msg_count, prc.conts);
+    EXPECT_TRUE(conn->eos());
+
+    cout <<"Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+
+TEST(Protocol_mysqlx, pipeline)
+{
+  typedef foundation::test::Mem_stream<1024*1024> Stream;
+
+  try {
+
+    scoped_ptr<Stream> conn(new Stream());
+
+    Protocol proto(*conn);
+    Protocol_server srv(*conn);
+
+    const unsigned msg_count = 10;
+
+    struct : public Init_processor
+    {
+      unsigned msgs;
+
+      void auth_start(const char*, bytes, bytes)
+      {
+        msgs++;
+      }
+
+      void auth_continue(bytes)
+      {
+        msgs++;
+      }
+
+    } prc;
+
+    prc.msgs = 0;
+
+    // Pipelined messages are buffered until pipelining is disabled.
+
+    proto.set_pipeline(true);
+
+    proto.snd_AuthenticateStart("test", bytes("start"), bytes("")).wait();
+    for (unsigned i = 0; i < msg_count; ++i)
+      proto.snd_AuthenticateContinue(bytes("continue")).wait();
+
+    EXPECT_TRUE(conn->eos());
+
+    proto.set_pipeline(false);
+
+    EXPECT_FALSE(conn->eos());
+
+    for (unsigned i = 0; i <= msg_count; ++i)
+      srv.rcv_InitMessage(prc).wait();
+
+    EXPECT_EQ(msg_count + 1, prc.msgs);
+    EXPECT_TRUE(conn->eos());
+
+    // Pending output is not sent when it grows big, but it can be sent
+    // in parts.
+
+    std::string big(64*1024, 'x');
+
+    proto.set_pipeline(true);
+
+    proto.snd_AuthenticateContinue(bytes("continue")).wait();
+    size_t first = proto.pipeline_pending();
+    proto.snd_AuthenticateContinue(
+      bytes((byte*)big.data(), big.size())).wait();
+    EXPECT_TRUE(conn->eos());
+    EXPECT_LT(big.size(), proto.pipeline_pending());
+
+    proto.pipeline_flush(first);
+    EXPECT_FALSE(conn->eos());
+    EXPECT_LT(big.size(), proto.pipeline_pending() + first);
+
+    srv.rcv_InitMessage(prc).wait();
+    EXPECT_EQ(msg_count + 2, prc.msgs);
+    EXPECT_TRUE(conn->eos());
+
+    proto.set_pipeline(false);
+    EXPECT_EQ(0, proto.pipeline_pending());
+
+    srv.rcv_InitMessage(prc).wait();
+    EXPECT_EQ(msg_count + 3, prc.msgs);
+    EXPECT_TRUE(conn->eos());
+
+    cout <<"Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
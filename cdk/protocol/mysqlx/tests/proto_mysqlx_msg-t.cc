@@ -28,6 +28,11 @@
 #include "test.h"
 //#include "expr.h"
 #include <list>
+#include <vector>
+
+PUSH_PB_WARNINGS
+#include "protobuf/mysqlx_sql.pb.h"
+POP_PB_WARNINGS
 
 
 #include "json_parser.h"
@@ -468,5 +473,267 @@ TEST(Protocol_mysqlx_msg, insert)
   CATCH_TEST_GENERIC;
 }
 
-}}  // cdk::test
 
+
+/*
+  Check that rows are correctly decoded from raw message payload. Server
+  reply is written directly to an in-memory stream and then read by
+  the client-side protocol object.
+*/
+
+static void write_frame(foundation::test::Mem_stream_base &str,
+                        msg_type_t type, std::string buf)
+{
+  msg_size_t size = static_cast<msg_size_t>(buf.size() + 1);
+  HTONSIZE(size);
+  buf.insert(0, 1, (char)type);
+  buf.insert(0, (const char*)&size, sizeof(size));
+
+  foundation::test::Mem_stream_base::Write_op
+    wr(str, buffers((byte*)buf.data(), buf.size()));
+  wr.wait();
+}
+
+static void write_frame(foundation::test::Mem_stream_base &str,
+                        msg_type_t type, const Message &msg)
+{
+  std::string buf;
+  msg.SerializeToString(&buf);
+  write_frame(str, type, buf);
+}
+
+
+static void read_frame(foundation::test::Mem_stream_base &str,
+                       msg_type_t type, Message &msg)
+{
+  byte hdr[5];
+
+  foundation::test::Mem_stream_base::Read_op
+    rd(str, buffers(hdr, sizeof(hdr)));
+  rd.wait();
+
+  msg_size_t size;
+  memcpy(&size, hdr, sizeof(size));
+  NTOHSIZE(size);
+
+  EXPECT_EQ(type, (msg_type_t)hdr[4]);
+
+  std::vector<byte> buf(size);
+
+  if (size > 1)
+  {
+    foundation::test::Mem_stream_base::Read_op
+      rd_payload(str, buffers(buf.data(), size - 1));
+    rd_payload.wait();
+  }
+
+  EXPECT_TRUE(msg.ParseFromArray(buf.data(), (int)size - 1));
+}
+
+
+TEST(Protocol_mysqlx_msg, rows)
+{
+  TRY_TEST_GENERIC
+  {
+    foundation::test::Mem_stream<16*1024> conn;
+    Protocol proto(conn);
+
+    Mysqlx::Resultset::ColumnMetaData md;
+    md.set_type(Mysqlx::Resultset::ColumnMetaData::BYTES);
+    md.set_name("a");
+    write_frame(conn, msg_type::ColumnMetaData, md);
+    md.set_name("b");
+    write_frame(conn, msg_type::ColumnMetaData, md);
+
+    Mysqlx::Resultset::Row row;
+    row.add_field("foo");
+    row.add_field("");
+    write_frame(conn, msg_type::Row, row);
+
+    row.Clear();
+    row.add_field(std::string(1000, 'x'));
+    row.add_field("bar");
+    write_frame(conn, msg_type::Row, row);
+
+    Mysqlx::Resultset::FetchDone done;
+    write_frame(conn, msg_type::FetchDone, done);
+
+    Mysqlx::Sql::StmtExecuteOk ok;
+    write_frame(conn, msg_type::StmtExecuteOk, ok);
+
+    struct : public protocol::mysqlx::Mdata_processor
+    {
+      col_count_t m_cols;
+      void col_count(col_count_t count) { m_cols = count; }
+    } mdp;
+
+    mdp.m_cols = 0;
+    proto.rcv_MetaData(mdp).wait();
+    EXPECT_EQ(2U, mdp.m_cols);
+
+    struct : public protocol::mysqlx::Row_processor
+    {
+      std::vector<std::string> m_fields;
+      unsigned m_rows;
+      bool m_done;
+
+      bool row_begin(row_count_t)
+      {
+        m_rows++;
+        return true;
+      }
+
+      void col_null(col_count_t)
+      {
+        m_fields.push_back("<null>");
+      }
+
+      size_t col_begin(col_count_t, size_t)
+      {
+        m_fields.push_back(std::string());
+        return 7;  // read data in small chunks
+      }
+
+      size_t col_data(col_count_t, bytes data)
+      {
+        m_fields.back().append((const char*)data.begin(), data.size());
+        return 7;
+      }
+
+      void done(bool, bool)
+      {
+        m_done = true;
+      }
+    } rp;
+
+    rp.m_rows = 0;
+    rp.m_done = false;
+    proto.rcv_Rows(rp).wait();
+
+    EXPECT_EQ(2U, rp.m_rows);
+    EXPECT_TRUE(rp.m_done);
+    ASSERT_EQ(4U, rp.m_fields.size());
+    EXPECT_EQ(std::string("foo"), rp.m_fields[0]);
+    EXPECT_EQ(std::string("<null>"), rp.m_fields[1]);
+    EXPECT_EQ(std::string(1000, 'x'), rp.m_fields[2]);
+    EXPECT_EQ(std::string("bar"), rp.m_fields[3]);
+
+    struct : public protocol::mysqlx::Stmt_processor
+    {
+      bool m_ok;
+      void execute_ok() { m_ok = true; }
+    } sp;
+
+    sp.m_ok = false;
+    proto.rcv_StmtReply(sp).wait();
+    EXPECT_TRUE(sp.m_ok);
+
+    cout <<"== Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+
+TEST(Protocol_mysqlx_msg, reuse)
+{
+  TRY_TEST_GENERIC
+  {
+    foundation::test::Mem_stream<16*1024> conn;
+    Protocol proto(conn);
+
+    /*
+      Message objects are re-used by the protocol - check that fields set
+      for the first message do not leak into the next one.
+    */
+
+    proto.snd_StmtExecute("sql", "SELECT 1", NULL).wait();
+    proto.snd_StmtExecute(NULL, "SELECT 2", NULL).wait();
+
+    Mysqlx::Sql::StmtExecute stmt;
+
+    read_frame(conn, msg_type::cli_StmtExecute, stmt);
+    EXPECT_TRUE(stmt.has_namespace_());
+    EXPECT_EQ(std::string("sql"), stmt.namespace_());
+    EXPECT_EQ(std::string("SELECT 1"), stmt.stmt());
+
+    read_frame(conn, msg_type::cli_StmtExecute, stmt);
+    EXPECT_FALSE(stmt.has_namespace_());
+    EXPECT_EQ(std::string("SELECT 2"), stmt.stmt());
+
+    EXPECT_TRUE(conn.eos());
+
+    cout <<"== Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+
+/*
+  Malformed row payload is reported as an error of the receive operation,
+  like any message which can not be parsed. The remaining messages of
+  the reply are still consumed.
+*/
+
+TEST(Protocol_mysqlx_msg, rows_malformed)
+{
+  TRY_TEST_GENERIC
+  {
+    foundation::test::Mem_stream<16*1024> conn;
+    Protocol proto(conn);
+
+    Mysqlx::Resultset::ColumnMetaData md;
+    md.set_type(Mysqlx::Resultset::ColumnMetaData::BYTES);
+    md.set_name("a");
+    write_frame(conn, msg_type::ColumnMetaData, md);
+
+    // Field length (10) is bigger than the remaining payload.
+
+    write_frame(conn, msg_type::Row, std::string("\x0A\x0A" "ab", 4));
+
+    Mysqlx::Resultset::FetchDone done;
+    write_frame(conn, msg_type::FetchDone, done);
+
+    Mysqlx::Sql::StmtExecuteOk ok;
+    write_frame(conn, msg_type::StmtExecuteOk, ok);
+
+    struct : public protocol::mysqlx::Mdata_processor
+    {
+      void col_count(col_count_t) {}
+    } mdp;
+
+    proto.rcv_MetaData(mdp).wait();
+
+    struct : public protocol::mysqlx::Row_processor
+    {
+      bool row_begin(row_count_t) { return true; }
+      void col_null(col_count_t) {}
+      size_t col_begin(col_count_t, size_t) { return 1024; }
+      size_t col_data(col_count_t, bytes) { return 1024; }
+    } rp;
+
+    try {
+      proto.rcv_Rows(rp).wait();
+      FAIL() << "Expected error for malformed row";
+    }
+    catch (const Error &e)
+    {
+      cout << "Expected error: " << e << endl;
+      EXPECT_EQ(cdkerrc::protobuf_error, e.code());
+    }
+
+    // The error is reported also by the last stage of the operation.
+
+    struct : public protocol::mysqlx::Stmt_processor
+    {
+    } sp;
+
+    EXPECT_THROW(proto.rcv_StmtReply(sp).wait(), Error);
+    EXPECT_TRUE(conn.eos());
+
+    cout <<"== Done!" <<endl;
+  }
+  CATCH_TEST_GENERIC;
+}
+
+
+}}  // cdk::test
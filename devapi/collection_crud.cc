@@ -28,7 +28,6 @@
 #include <time.h>
 #include <sstream>
 #include <forward_list>
-#include <boost/format.hpp>
 #include <list>
 
 #include "impl.h"
@@ -42,12 +41,7 @@ void mysqlx::GUID::generate()
 {
   uuid::uuid_type uuid;
   mysqlx::generate_uuid(uuid);
-  boost::format fmt("%02X");
-
-  for (unsigned i = 0; i < sizeof(uuid) && 2 * i < sizeof(m_data); ++i)
-  {
-    memcpy(m_data + 2 * i, (fmt % (unsigned)uuid[i]).str().data(), 2);
-  }
+  uuid::to_hex(uuid, m_data);
 }
 
 
@@ -83,8 +77,12 @@ class Op_collection_add
   std::vector<string> m_json;
   mysqlx::GUID  m_id;
   std::vector<mysqlx::GUID> m_id_list;
+  std::vector<mysqlx::GUID> m_gen_ids;
+  string m_doc;
   bool  m_generated_id;
   unsigned m_pos;
+  unsigned m_chunk_end;
+  Chunk_limits m_chunk_limits;
 
 
   Op_collection_add(Collection &coll)
@@ -92,6 +90,7 @@ class Op_collection_add
     , m_coll(coll)
     , m_generated_id(true)
     , m_pos(0)
+    , m_chunk_end(0)
   {}
 
   Executable_impl* clone() const override
@@ -105,6 +104,11 @@ class Op_collection_add
     m_json.push_back(json);
   }
 
+  void set_chunk_size(row_count_t docs, size_t bytes) override
+  {
+    m_chunk_limits.set(docs, bytes);
+  }
+
 
   cdk::Reply* send_command() override
   {
@@ -113,16 +117,94 @@ class Op_collection_add
     if (m_json.empty())
       return NULL;
 
-    // Issue coll_add statement where documents are described by list
-    // of expressions defined by this instance.
+    // Prepare for a pass through m_json list (the operation can be
+    // executed more than once).
+
+    m_pos = 0;
+    m_chunk_end = 0;
+    m_id_list.clear();
+    m_id_list.reserve(m_json.size());
+
+    // Generate ids for all documents at once -- they are used for
+    // documents which do not have their own _id.
+
+    generate_ids(m_json.size());
+
+    // If all documents fit into a single chunk, send them in one command.
+
+    next_chunk();
+
+    if (m_chunk_end >= m_json.size())
+      return send_chunk();
+
+    return send_chunks(
+      [this]() { return send_chunk(); },
+      [this]() { return next_chunk(); }
+    );
+  }
+
 
+  /*
+    Issue coll_add statement where documents from the current chunk are
+    described by list of expressions defined by this instance.
+  */
+
+  cdk::Reply* send_chunk()
+  {
     return new cdk::Reply(get_cdk_session().coll_add(m_coll, *this, NULL));
   }
 
 
+  /*
+    Move to the next chunk of documents, which starts after the current
+    one and contains as many documents as allowed by m_chunk_limits (but
+    at least one). Returns false if there are no more documents.
+  */
+
+  bool next_chunk()
+  {
+    m_pos = m_chunk_end;
+
+    if (m_chunk_end >= m_json.size())
+      return false;
+
+    row_count_t docs = 1;
+    size_t bytes = m_json[m_chunk_end++].size();
+
+    while (m_chunk_end < m_json.size())
+    {
+      bytes += m_json[m_chunk_end].size();
+      if (!m_chunk_limits.fits(++docs, bytes))
+        break;
+      ++m_chunk_end;
+    }
+
+    return true;
+  }
+
+
+  void generate_ids(size_t count)
+  {
+    std::unique_ptr<uuid::uuid_type[]> uuids(new uuid::uuid_type[count]);
+    mysqlx::generate_uuids(uuids.get(), count);
+
+    char buf[2 * sizeof(uuid::uuid_type) + 1];
+    buf[sizeof(buf) - 1] = '\0';
+
+    m_gen_ids.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      uuid::to_hex(uuids[i], buf);
+      m_gen_ids[i] = buf;
+    }
+  }
+
+
   internal::BaseResult mk_result(cdk::Reply *reply) override
   {
-    return Result::Access::mk(m_sess, reply, m_id_list);
+    if (m_chunks.empty())
+      return Result::Access::mk(m_sess, reply, m_id_list);
+    return Result::Access::mk(m_sess, reply, m_id_list, release_chunks());
   }
 
 
@@ -130,7 +212,7 @@ class Op_collection_add
 
   bool next() override
   {
-    if (m_pos >= m_json.size())
+    if (m_pos >= m_chunk_end)
       return false;
     ++m_pos;
     return true;
@@ -225,63 +307,202 @@ CATCH_AND_WRAP
 
 
 /*
-  Class describing elements of expression:
-
-    JSON_INSERT(<json>, '$._id', <id>)
-
-  where <json> and <id> are given as constructor parameters.
+  Fast scanner which looks for '_id' key in a JSON document string.
+
+  Only top-level keys of the document are examined and scanning stops
+  as soon as '_id' key is found. Values of other keys are skipped without
+  interpreting them (only nesting of documents/arrays and string literals
+  is tracked).
+
+  The scanner handles only the common case where the '_id' value is
+  a plain string without escape sequences and keys do not use escapes.
+  In all other cases (including malformed documents) it reports that
+  the document should be fully parsed with the JSON codec, which either
+  decodes the id or reports an error.
 */
 
-class Insert_id
-  : public cdk::api::Table_ref
-  , public cdk::Expr_list
+class Id_scanner
 {
+public:
+
   typedef cdk::string string;
 
-  const std::string m_json;
-  const std::string &m_id;
+  enum State { NOT_FOUND, FOUND, PARSE };
 
-  Insert_id(const string &json, const std::string &id)
-    : m_json(json)  // note: conversion to utf-8
-    , m_id(id)
-  {}
+  State  m_state;
+  size_t m_pos;    // position after the opening '{' of the document
+  bool   m_empty;  // true if document has no keys
+  string m_id;
+
+  Id_scanner(const string &json)
+    : m_state(PARSE), m_pos(string::npos), m_empty(false)
+  {
+    m_state = scan(json);
+  }
+
+private:
 
+  typedef string::const_iterator iterator;
 
-  // Table_ref (function name)
+  static bool is_ws(wchar_t c)
+  {
+    return L' ' == c || L'\t' == c || L'\n' == c || L'\r' == c;
+  }
 
-  const cdk::api::Schema_ref* schema() const { return NULL; }
-  const string name() const { return L"JSON_INSERT"; }
+  static bool skip_ws(iterator &it, const iterator &end)
+  {
+    while (it != end && is_ws(*it))
+      ++it;
+    return it != end;
+  }
 
+  /*
+    Skip string literal starting at `it`, which must point at the opening
+    quote. On success `it` points after the closing quote and `escaped`
+    tells if the string contains escape sequences.
+  */
 
-  // Expr_list (arguments)
+  static bool skip_str(iterator &it, const iterator &end, bool &escaped)
+  {
+    escaped = false;
+    for (++it; it != end; ++it)
+    {
+      if (L'\\' == *it)
+      {
+        escaped = true;
+        if (++it == end)
+          return false;
+        continue;
+      }
+      if (L'"' == *it)
+      {
+        ++it;
+        return true;
+      }
+    }
+    return false;
+  }
 
-  using cdk::Expr_list::Processor;
+  /*
+    Skip a value, leaving `it` at the ',' or '}' which follows it.
+  */
 
-  void process(Processor &lp) const
+  static bool skip_val(iterator &it, const iterator &end)
   {
-    lp.list_begin();   // FIXME
-    lp.list_el()->scalar()->val()->str(m_json);
-    lp.list_el()->scalar()->val()->str(L"$._id");
-    lp.list_el()->scalar()->val()->str(m_id);
-    lp.list_end();
+    unsigned depth = 0;
+    bool escaped;
+
+    while (it != end)
+    {
+      switch (*it)
+      {
+      case L'"':
+        if (!skip_str(it, end, escaped))
+          return false;
+        continue;
+
+      case L'{':
+      case L'[':
+        ++depth;
+        break;
+
+      case L'}':
+      case L']':
+        if (0 == depth)
+          return L'}' == *it;
+        --depth;
+        break;
+
+      case L',':
+        if (0 == depth)
+          return true;
+        break;
+      }
+      ++it;
+    }
+
+    return false;
   }
 
-  friend Op_collection_add;
+  State scan(const string &json)
+  {
+    iterator it = json.begin();
+    const iterator end = json.end();
+    bool escaped;
+
+    if (!skip_ws(it, end) || L'{' != *it)
+      return PARSE;
+
+    ++it;
+    m_pos = it - json.begin();
+
+    if (!skip_ws(it, end))
+      return PARSE;
+
+    if (L'}' == *it)
+    {
+      m_empty = true;
+      return NOT_FOUND;
+    }
+
+    for (;;)
+    {
+      // key
+
+      if (L'"' != *it)
+        return PARSE;
+
+      iterator key = it + 1;
+      if (!skip_str(it, end, escaped) || escaped)
+        return PARSE;
+
+      bool is_id = (it - key == 4) && L'_' == key[0] && L'i' == key[1]
+                   && L'd' == key[2];
+
+      if (!skip_ws(it, end) || L':' != *it)
+        return PARSE;
+      ++it;
+      if (!skip_ws(it, end))
+        return PARSE;
+
+      // value
+
+      if (is_id)
+      {
+        if (L'"' != *it)
+          return PARSE;
+
+        iterator val = it + 1;
+        if (!skip_str(it, end, escaped) || escaped)
+          return PARSE;
+
+        m_id.assign(val, it - 1);
+        return FOUND;
+      }
+
+      if (!skip_val(it, end))
+        return PARSE;
+
+      if (L'}' == *it)
+        return NOT_FOUND;
+
+      // *it == ','
+
+      ++it;
+      if (!skip_ws(it, end))
+        return PARSE;
+    }
+  }
 };
 
 
 /*
   Expression describing single document to be inserted.
 
-  If document id was generated, then expression is a call of
-  JSON_INSERT() function that adds generated id. Otherwise it
-  is plain JSON string of the document.
-
-  TODO:
-  - Append '_id' field at the end of document, instead of using
-    JSON_INSERT() (should be more efficient). If duplicate key is
-    found in a document string, only the first occurence is taken
-    into account.
+  If document does not have '_id' key, the generated id is spliced into
+  the document string as its first key and the document is sent as
+  a plain JSON string (this way server does not have to evaluate any
+  function for each document).
 */
 
 void Op_collection_add::process(cdk::Expression::Processor &ep) const
@@ -291,19 +512,56 @@ void Op_collection_add::process(cdk::Expression::Processor &ep) const
   const string &json = m_json.at(m_pos-1);
   auto self = const_cast<Op_collection_add*>(this);
 
-  // Parse JSON string to find _id if defined.
+  // Look for _id in the JSON string, parse it fully only if needed.
   // TODO: Avoid parsing (if inserted document id is returned by server).
 
-  cdk::Codec<cdk::TYPE_DOCUMENT> codec;
-  self->m_generated_id = true;
-  codec.from_bytes(cdk::bytes(json), *self);
+  Id_scanner scan(json);
+
+  switch (scan.m_state)
+  {
+  case Id_scanner::FOUND:
+    self->m_generated_id = false;
+    self->m_id = scan.m_id;
+    break;
+
+  case Id_scanner::NOT_FOUND:
+    self->m_generated_id = true;
+    break;
+
+  case Id_scanner::PARSE:
+    {
+      cdk::Codec<cdk::TYPE_DOCUMENT> codec;
+      self->m_generated_id = true;
+      codec.from_bytes(cdk::bytes(json), *self);
+    }
+    break;
+  }
 
   if (m_generated_id)
   {
-    self->m_id.generate();
+    using mysqlx::throw_error;
+
+    if (string::npos == scan.m_pos)
+      THROW("Invalid JSON document");
+
+    self->m_id = m_gen_ids.at(m_pos-1);
     std::string id(m_id);
-    Insert_id expr(json, id);
-    expr.process(*ep.scalar()->call(expr));
+
+    // Build the document string in a buffer re-used between documents.
+
+    string &doc = self->m_doc;
+    doc.clear();
+    doc.reserve(json.size() + id.size() + 10);
+    doc.append(json, 0, scan.m_pos);
+    doc.append(L"\"_id\":\"");
+    doc.append(id.begin(), id.end());
+    doc.push_back(L'"');
+    if (!scan.m_empty)
+      doc.push_back(L',');
+    doc.append(json, scan.m_pos, string::npos);
+
+    // TODO: ep.val(TYPE_DOCUMENT, json_format, cdk::bytes())
+    ep.scalar()->val()->str(doc);
   }
   else
   {
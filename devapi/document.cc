@@ -37,6 +37,7 @@
 #include <sstream>
 #include <iomanip>
 #include <memory>
+#include <algorithm>
 
 using namespace ::mysqlx;
 
@@ -57,7 +58,7 @@ void Value::print(ostream &out) const
   case DOUBLE: out << m_val._double_v; return;
   case FLOAT: out << m_val._float_v; return;
   case BOOL: out << (m_val._bool_v ? "true" : "false"); return;
-  case STRING: out << (std::string)m_str; return;
+  case STRING: out << getUtf8(); return;
   case DOCUMENT: out << m_doc; return;
   case RAW: out << "<" << m_raw.size() << " raw bytes>"; return;
   // TODO: print array contnets
@@ -309,18 +310,168 @@ public:
 };
 
 
+/*
+  JSON processor which stores a single JSON value in a Value object.
+*/
+
+struct DbDoc::Impl::Value_builder
+  : public cdk::JSON::Processor::Any_prc
+  , public cdk::JSON_processor
+{
+  Value *m_val = NULL;
+
+  // Any_prc
+
+  Scalar_prc *scalar() { return this; }
+
+  std::unique_ptr<Builder> m_doc_builder;
+
+  Doc_prc    *doc()
+  {
+    m_val->m_type = Value::DOCUMENT;
+    m_val->m_doc.m_impl = std::make_shared<DbDoc::Impl>();
+    m_doc_builder.reset(new Builder(*m_val->m_doc.m_impl));
+    return m_doc_builder.get();
+  }
+
+  Builder::Arr_builder m_arr_builder;
+
+  List_prc   *arr()
+  {
+    m_val->m_type = Value::ARRAY;
+    m_val->m_arr = std::make_shared<Value::Array>();
+    m_arr_builder.m_arr = m_val->m_arr.get();
+    return &m_arr_builder;
+  }
+
+  // JSON_processor
+
+  void null() {}
+
+  void str(const cdk::string &val)
+  {
+    *m_val = (mysqlx::string)val;
+  }
+
+  void num(uint64_t val) { *m_val = val; }
+  void num(int64_t val)  { *m_val = val; }
+  void num(float val)    { *m_val = val; }
+  void num(double val)   { *m_val = val; }
+  void yesno(bool val)   { *m_val = val; }
+};
+
+
+void DbDoc::Impl::JSONDoc::build_index()
+{
+  if (m_indexed)
+    return;
+
+  parser::JSON_utf8_parser json{ cdk::bytes(m_json) };
+  json.index(m_index);
+  m_indexed = true;
+}
+
+
+/*
+  Return index entry for the given field or NULL if document does
+  not have such field.
+*/
+
+auto DbDoc::Impl::JSONDoc::find(const Field &fld) -> const Index::value_type*
+{
+  build_index();
+
+  const std::string key((const string&)fld);
+
+  auto it = std::lower_bound(m_index.begin(), m_index.end(), key,
+    [](const Index::value_type &entry, const std::string &key)
+    {
+      return entry.key < key;
+    });
+
+  if (it == m_index.end() || it->key != key)
+    return NULL;
+
+  return &(*it);
+}
+
+
+/*
+  Return value of the given field, decoding it from the JSON string
+  if this was not done before. Decoded values are kept in the map so
+  that references to them remain valid.
+*/
+
+const Value&
+DbDoc::Impl::JSONDoc::decode(const Index::value_type &entry, const Field &fld)
+{
+  auto found = m_map.find(fld);
+
+  if (m_map.end() != found)
+    return found->second;
+
+  const char *begin = m_json.data() + entry.begin;
+  size_t      len = entry.end - entry.begin;
+  Value       val;
+
+  if ('{' == *begin)
+  {
+    // Sub-document is decoded only when its fields are accessed.
+
+    val.m_type = Value::DOCUMENT;
+    val.m_doc.m_impl = std::make_shared<JSONDoc>(std::string(begin, len));
+  }
+  else
+  {
+    Value_builder bld;
+    bld.m_val = &val;
+    parser::JSON_utf8_parser::process_value(
+      cdk::bytes((cdk::byte*)begin, len), bld
+    );
+  }
+
+  return m_map.emplace(fld, std::move(val)).first->second;
+}
+
+
 void DbDoc::Impl::JSONDoc::prepare()
 {
   if (m_parsed)
     return;
 
-  cdk::Codec<cdk::TYPE_DOCUMENT> codec;
-  Builder bld(*this);
-  codec.from_bytes(cdk::bytes(m_json), bld);
+  build_index();
+
+  for (const Index::value_type &entry : m_index)
+    decode(entry, Field(string(entry.key)));
+
   m_parsed = true;
 }
 
 
+bool DbDoc::Impl::JSONDoc::has_field(const Field &fld)
+{
+  if (m_parsed)
+    return m_map.end() != m_map.find(fld);
+  return NULL != find(fld);
+}
+
+
+const Value& DbDoc::Impl::JSONDoc::get(const Field &fld) const
+{
+  JSONDoc *self = const_cast<JSONDoc*>(this);
+
+  if (m_parsed)
+    return m_map.at(fld);
+
+  const Index::value_type *entry = self->find(fld);
+
+  if (!entry)
+    throw std::out_of_range("Document does not have the requested field");
+
+  return self->decode(*entry, fld);
+}
+
+
 /*
   Parse JSON string and build a corresponding Value.
 */
@@ -339,60 +490,10 @@ Value Value::Access::mk_from_json(const std::string &json)
   auto first = toks.begin();
   Parser parser(first, toks.end());
 
-  /*
-    Define builder which acts as JSON value processor and
-    builds the corresponding Value object.
-  */
-
-  struct Builder :
-    public cdk::JSON::Processor::Any_prc
-    , cdk::JSON_processor
-  {
-    Value *m_val = NULL;
-
-    // Any_prc
-
-    Scalar_prc *scalar() { return this; }
-
-    std::unique_ptr<DbDoc::Impl::Builder> m_doc_builder;
-
-    Doc_prc    *doc()
-    {
-      m_val->m_type = DOCUMENT;
-      m_doc_builder.reset(new DbDoc::Impl::Builder(*m_val->m_doc.m_impl));
-      return m_doc_builder.get();
-    }
-
-    DbDoc::Impl::Builder::Arr_builder m_arr_builder;
-
-    List_prc   *arr()
-    {
-      m_val->m_type = ARRAY;
-      m_val->m_arr = std::make_shared<Array>();
-      m_arr_builder.m_arr = m_val->m_arr.get();
-      return &m_arr_builder;
-    }
-
-    // JSON_processor
-
-    void null() {}
-
-    void str(const cdk::string &val)
-    {
-      *m_val = (mysqlx::string)val;
-    }
-
-    void num(uint64_t val) { *m_val = val; }
-    void num(int64_t val)  { *m_val = val; }
-    void num(float val)    { *m_val = val; }
-    void num(double val)   { *m_val = val; }
-    void yesno(bool val)   { *m_val = val; }
-  }
-  builder;
-
   // Invoke parser to build the value.
 
   Value val;
+  DbDoc::Impl::Value_builder builder;
   builder.m_val = &val;
   parser.process(builder);
 
@@ -33,10 +33,14 @@
 #include <mysql/cdk.h>
 #include <mysql/cdk/converters.h>
 #include <expr_parser.h>
+#include <json_parser.h>
+#include <deque>
 #include <map>
 #include <memory>
 #include <stack>
 #include <list>
+#include <mutex>
+#include <unordered_map>
 
 #include "../global.h"
 
@@ -65,6 +69,20 @@ struct Value::Access
     return std::move(ret);
   }
 
+  /*
+    Build string value from UTF-8 encoded string. Conversion to wide
+    string is done only if the value is requested as mysqlx::string.
+  */
+
+  static Value mk_utf8(std::string &&utf8)
+  {
+    Value ret;
+    ret.m_type = Value::STRING;
+    ret.m_utf8 = std::move(utf8);
+    ret.m_has_utf8 = true;
+    return ret;
+  }
+
   /*
     Build value after parsing given JSON string. Depending
     on the string, the value can be a document, array or
@@ -72,6 +90,33 @@ struct Value::Access
   */
 
   static Value mk_from_json(const std::string &json);
+
+  /*
+    Rough estimate of the number of bytes needed to send given value
+    to the server (used to split bulk inserts into chunks).
+  */
+
+  static size_t size_estimate(const Value &val)
+  {
+    switch (val.m_type)
+    {
+    case Value::STRING:
+      return val.m_has_utf8 ? val.m_utf8.size() : val.m_str.size();
+    case Value::RAW:
+      return val.m_raw.size();
+    case Value::ARRAY:
+      {
+        size_t size = 0;
+        for (const Value &el : *val.m_arr)
+          size += size_estimate(el);
+        return size;
+      }
+    case Value::DOCUMENT:
+      return 64;
+    default:
+      return 8;
+    }
+  }
 };
 
 
@@ -344,13 +389,13 @@ class DbDoc::Impl
   typedef std::map<Field, Value> Map;
   Map m_map;
 
-  bool has_field(const Field &fld)
+  virtual bool has_field(const Field &fld)
   {
     prepare();
     return m_map.end() != m_map.find(fld);
   }
 
-  const Value& get(const Field &fld) const
+  virtual const Value& get(const Field &fld) const
   {
     const_cast<Impl*>(this)->prepare();
     return m_map.at(fld);
@@ -367,8 +412,10 @@ class DbDoc::Impl
   bool at_end() const { return m_it == m_map.end(); }
 
   struct Builder;
+  struct Value_builder;
 
   friend DocResult;
+  friend DocList;
   friend DbDoc;
   friend RowResult;
   friend Value::Access;
@@ -378,23 +425,48 @@ class DbDoc::Impl
 /*
   DbDoc::Impl specialization which takes document data from
   a JSON string.
+
+  Accessing a single field does not parse the whole document. Instead,
+  an index of top-level keys is built first and only the value of the
+  requested field is decoded and stored in the map. Sub-documents are
+  stored as JSONDoc instances over the corresponding part of the JSON
+  string so that they are also decoded on demand. The whole document is
+  decoded only when iterating over its fields.
 */
 
 class DbDoc::Impl::JSONDoc
   : public DbDoc::Impl
 {
+  typedef parser::JSON_utf8_parser::Index Index;
+
   std::string m_json;
   bool m_parsed;
+  bool m_indexed;
+  Index m_index;
+
+  void build_index();
+  const Index::value_type* find(const Field&);
+  const Value& decode(const Index::value_type&, const Field&);
 
 public:
 
   JSONDoc(const std::string &json)
     : m_json(json)
     , m_parsed(false)
+    , m_indexed(false)
+  {}
+
+  JSONDoc(std::string &&json)
+    : m_json(std::move(json))
+    , m_parsed(false)
+    , m_indexed(false)
   {}
 
   void prepare();
 
+  bool has_field(const Field &fld);
+  const Value& get(const Field &fld) const;
+
   void print(std::ostream &out) const
   {
     out << m_json;
@@ -441,6 +513,22 @@ class DocResult::Impl
 };
 
 
+/*
+  Storage for documents returned by DocResult::fetchMany(). DbDoc
+  instances returned from a DocList share ownership of this storage.
+  A deque is used so that documents are not moved while the list is
+  being filled.
+*/
+
+class DocList::Impl
+{
+  std::deque<DbDoc::Impl::JSONDoc> m_docs;
+
+  friend DocList;
+  friend DocResult;
+};
+
+
 // --------------------------------------------------------------------
 
 
@@ -475,6 +563,337 @@ struct internal::BaseResult::Access
   {
     return BaseResult(sess, a, b);
   }
+
+  template <typename A, typename B, typename C>
+  static BaseResult mk(XSession_base *sess, A a, B b, C c)
+  {
+    return BaseResult(sess, a, b, c);
+  }
+};
+
+
+// --------------------------------------------------------------------
+
+/*
+  Parsed expressions
+  ==================
+
+  CRUD operations keep selection criteria, sort, grouping and projection
+  specifications in the form of strings given by user. Instead of running
+  the parser over these strings each time an operation is sent to the
+  server, each string is parsed only once, when it is used for the first
+  time, and the result is stored using parser::Stored_any (which records
+  callbacks reported by the parser). Subsequent executions of the same
+  operation, or of its copies, re-play the stored parse result which is
+  much cheaper than parsing.
+
+  Parsing is delayed until first use so that errors in expression strings
+  are still reported when the operation is executed.
+
+  Parse results are also shared between different operations which use
+  the same specification strings: they are kept in a process-wide
+  Parse_cache (see below), so that operations created over and over again
+  for the same statement shape do not parse their expressions each time.
+*/
+
+/*
+  Parse result of an "<expr> [ASC|DESC]" sort specification.
+*/
+
+struct Stored_order
+  : public cdk::api::Order_expr<cdk::Expression>
+  , public cdk::api::Order_expr<cdk::Expression>::Processor
+{
+  cdk::api::Sort_direction::value m_dir = cdk::api::Sort_direction::ASC;
+  parser::Stored_any m_expr;
+
+  // Order_expr (report stored specification)
+
+  void process(cdk::api::Order_expr<cdk::Expression>::Processor &prc) const
+  {
+    m_expr.process_if(prc.sort_key(m_dir));
+  }
+
+  // Order_expr processor (store specification)
+
+  Expr_prc* sort_key(cdk::api::Sort_direction::value dir)
+  {
+    m_dir = dir;
+    return &m_expr;
+  }
+};
+
+
+/*
+  Parse result of a "<expr> [AS <alias>]" projection specification. It can
+  be reported either as an element of a table projection, or as a field
+  of a document projection.
+*/
+
+struct Stored_projection
+  : public cdk::api::Projection_expr<cdk::Expression>
+  , public cdk::Expression::Document
+  , public cdk::api::Projection_expr<cdk::Expression>::Processor
+  , public cdk::Expression::Document::Processor
+{
+  typedef cdk::api::Projection_expr<cdk::Expression>::Processor Projection_prc;
+  typedef cdk::Expression::Document::Processor Document_prc;
+
+  parser::Stored_any m_expr;
+  cdk::string m_alias;
+  bool m_has_alias = false;
+
+  // Projection_expr and Document (report stored specification)
+
+  void process(Projection_prc &prc) const
+  {
+    m_expr.process_if(prc.expr());
+    if (m_has_alias)
+      prc.alias(m_alias);
+  }
+
+  void process(Document_prc &prc) const
+  {
+    m_expr.process_if(prc.key_val(m_alias));
+  }
+
+  // Projection_expr processor (store specification)
+
+  Projection_prc::Expr_prc* expr()
+  {
+    return &m_expr;
+  }
+
+  void alias(const cdk::string &name)
+  {
+    m_alias = name;
+    m_has_alias = true;
+  }
+
+  // Document processor (store specification)
+
+  void doc_begin() {}
+  void doc_end() {}
+
+  Document_prc::Any_prc* key_val(const cdk::string &key)
+  {
+    alias(key);
+    return &m_expr;
+  }
+};
+
+
+/*
+  Process-wide cache of parse results of type Stored, keyed by the parsed
+  string and parser mode. When the number of entries grows above
+  `capacity`, the least recently used entry is removed. Parse results are
+  immutable and held by shared pointers, so removing an entry does not
+  affect operations which still use it.
+
+  The Tag parameter is used to have separate caches for different uses
+  of the same Stored type.
+
+  Method get() can be called from different threads. Parsing is done
+  outside of the cache lock -- if two threads parse the same string at
+  the same time, both get the result which was stored first.
+*/
+
+template <class Stored, class Tag = Stored>
+class Parse_cache
+{
+public:
+
+  typedef std::shared_ptr<const Stored> Ptr;
+
+  static const size_t capacity = 1024;
+
+  static Parse_cache& instance()
+  {
+    static Parse_cache cache;
+    return cache;
+  }
+
+  template <class F>
+  Ptr get(parser::Parser_mode::value mode, const cdk::string &text, F parse)
+  {
+    Key key(mode, text);
+
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      auto it = m_map.find(key);
+      if (it != m_map.end())
+        return touch(it->second);
+    }
+
+    std::shared_ptr<Stored> parsed = std::make_shared<Stored>();
+    parse(*parsed);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto res = m_map.emplace(key, m_lru.end());
+    if (!res.second)
+      return touch(res.first->second);
+
+    m_lru.emplace_front(key, parsed);
+    res.first->second = m_lru.begin();
+
+    if (m_lru.size() > capacity)
+    {
+      m_map.erase(m_lru.back().first);
+      m_lru.pop_back();
+    }
+
+    return parsed;
+  }
+
+private:
+
+  typedef std::pair<parser::Parser_mode::value, cdk::string> Key;
+  typedef std::list<std::pair<Key, Ptr>> Lru_list;
+
+  struct Key_hash
+  {
+    size_t operator()(const Key &key) const
+    {
+      return std::hash<std::wstring>()(key.second) ^ (size_t)key.first;
+    }
+  };
+
+  std::mutex m_lock;
+  Lru_list   m_lru;
+  std::unordered_map<Key, typename Lru_list::iterator, Key_hash> m_map;
+
+  // Move given entry to the front of LRU list and return its parse result.
+
+  Ptr touch(typename Lru_list::iterator it)
+  {
+    m_lru.splice(m_lru.begin(), m_lru, it);
+    return it->second;
+  }
+};
+
+
+/*
+  Base for classes which hold a specification string together with its
+  parse result. The parse result is obtained on first call to get() from
+  Parse_cache (which uses the `parse` callback if the string was not
+  parsed before) and then shared with all copies of this object.
+*/
+
+template <class Stored>
+class Parsed_base
+{
+protected:
+
+  parser::Parser_mode::value m_mode = parser::Parser_mode::DOCUMENT;
+  cdk::string m_text;
+  mutable std::shared_ptr<const Stored> m_parsed;
+
+  Parsed_base() = default;
+  Parsed_base(parser::Parser_mode::value mode, const cdk::string &text)
+    : m_mode(mode), m_text(text)
+  {}
+
+  template <class F>
+  const Stored& get(F parse) const
+  {
+    if (!m_parsed)
+      m_parsed = Parse_cache<Stored>::instance().get(m_mode, m_text, parse);
+    return *m_parsed;
+  }
+
+public:
+
+  bool empty() const
+  {
+    return m_text.empty();
+  }
+};
+
+
+class Parsed_expr
+  : public Parsed_base<parser::Stored_any>
+  , public cdk::Expression
+{
+public:
+
+  Parsed_expr() = default;
+  Parsed_expr(parser::Parser_mode::value mode, const cdk::string &expr)
+    : Parsed_base(mode, expr)
+  {}
+
+  void process(Processor &prc) const
+  {
+    get([this](parser::Stored_any &store) {
+      parser::Expression_parser parser(m_mode, m_text);
+      parser.process(store);
+    }).process(prc);
+  }
+};
+
+
+class Parsed_order
+  : public Parsed_base<Stored_order>
+  , public cdk::api::Order_expr<cdk::Expression>
+{
+public:
+
+  Parsed_order(parser::Parser_mode::value mode, const cdk::string &order)
+    : Parsed_base(mode, order)
+  {}
+
+  void process(Processor &prc) const
+  {
+    get([this](Stored_order &store) {
+      parser::Order_parser parser(m_mode, m_text);
+      parser.process(store);
+    }).process(prc);
+  }
+};
+
+
+/*
+  Note: projection specifications are validated differently when used
+  in document projection (where alias is mandatory), therefore parse
+  results for the two uses are stored separately.
+*/
+
+class Parsed_projection
+  : public Parsed_base<Stored_projection>
+  , public cdk::api::Projection_expr<cdk::Expression>
+  , public cdk::Expression::Document
+{
+  typedef Stored_projection::Projection_prc Projection_prc;
+  typedef Stored_projection::Document_prc   Document_prc;
+
+  mutable std::shared_ptr<const Stored_projection> m_doc_parsed;
+
+public:
+
+  Parsed_projection(parser::Parser_mode::value mode, const cdk::string &proj)
+    : Parsed_base(mode, proj)
+  {}
+
+  void process(Projection_prc &prc) const
+  {
+    get([this](Stored_projection &store) {
+      parser::Projection_parser parser(m_mode, m_text);
+      parser.process(static_cast<Projection_prc&>(store));
+    }).process(prc);
+  }
+
+  void process(Document_prc &prc) const
+  {
+    if (!m_doc_parsed)
+      m_doc_parsed
+        = Parse_cache<Stored_projection, Document_prc>::instance().get(
+            m_mode, m_text,
+            [this](Stored_projection &store) {
+              parser::Projection_parser parser(m_mode, m_text);
+              parser.process(static_cast<Document_prc&>(store));
+            });
+    m_doc_parsed->process(prc);
+  }
 };
 
 
@@ -531,8 +950,38 @@ struct internal::BaseResult::Access
   `Impl` that derived class wants to implement. The Op_base template
   implements some of the interface methods, other templates and derived
   class should implement the rest.
+
+  Insert operations with many rows or documents can be sent in several
+  chunks, using method `send_chunks` (see also Chunk_limits below).
+*/
+
+/*
+  Limits for the size of a single chunk of bulk insert operation. Value 0
+  means no limit. By default there are no limits and the whole operation
+  is sent as a single (atomic) command. Chunking must be requested
+  explicitly, because an error in one chunk does not undo the chunks
+  processed before it.
 */
 
+struct Chunk_limits
+{
+  row_count_t m_rows = 0;
+  size_t      m_bytes = 0;
+
+  void set(row_count_t rows, size_t bytes)
+  {
+    m_rows = rows;
+    m_bytes = bytes;
+  }
+
+  bool fits(row_count_t rows, size_t bytes) const
+  {
+    return (0 == m_rows || rows <= m_rows)
+           && (0 == m_bytes || bytes <= m_bytes);
+  }
+};
+
+
 template<class Impl>
 class Op_base
   : public Impl
@@ -646,11 +1095,144 @@ protected:
   }
 
 
+  // Chunked execution
+
+  /*
+    Replies for all but the last chunk of an operation sent by
+    send_chunks(). These replies are completed and their ownership
+    passes to the result object created by mk_result().
+  */
+
+  std::vector<std::unique_ptr<cdk::Reply>> m_chunks;
+
+  /*
+    Maximal number of chunks which are sent to the server before
+    waiting for a reply to the first of them.
+  */
+
+  static const size_t max_chunks_in_flight = 4;
+
+  /*
+    Send operation to the server in several chunks, each one being
+    a separate command. Function `send` sends command for the current
+    chunk and returns its reply. Function `next` moves to the next
+    chunk and returns false if there are no more chunks.
+
+    Commands are pipelined so that serializing and sending a chunk
+    overlaps with the server processing the previous ones. Replies for
+    all chunks except the last one are processed here and if any of them
+    reports an error, the error is thrown. The reply for the last chunk
+    is returned.
+
+    Note: Chunks which were sent before an error is detected are
+    processed by the server (one can use a transaction to roll them
+    back). This includes up to max_chunks_in_flight-1 chunks which follow
+    the failing one. Their replies are discarded before the error is
+    thrown, so that the session can be used for further commands.
+  */
+
+  template <class Send, class Next>
+  cdk::Reply* send_chunks(Send send, Next next)
+  {
+    cdk::Session &sess = get_cdk_session();
+    bool pipeline = sess.is_pipeline();
+    std::unique_ptr<cdk::Reply> last;
+    size_t done = 0;
+
+    m_chunks.clear();
+    sess.set_pipeline(true);
+
+    try {
+
+      do {
+        if (last)
+          m_chunks.push_back(std::move(last));
+        last.reset(send());
+
+        while (m_chunks.size() - done >= max_chunks_in_flight)
+          complete_chunk(*m_chunks[done++]);
+      }
+      while (next());
+
+      while (done < m_chunks.size())
+        complete_chunk(*m_chunks[done++]);
+    }
+    catch (...)
+    {
+      sess.set_pipeline(pipeline);
+      discard_chunks(done, last.get());
+      throw;
+    }
+
+    sess.set_pipeline(pipeline);
+    return last.release();
+  }
+
+  static void complete_chunk(cdk::Reply &reply)
+  {
+    reply.wait();
+    if (0 < reply.entry_count())
+      reply.get_error().rethrow();
+
+    // Note: reply keeps statistics and diagnostics after discarding it.
+
+    reply.discard();
+  }
+
+  /*
+    Discard replies of chunks which were sent but not yet completed,
+    starting from chunk number `from`, and of the `last` one. Errors
+    reported by these chunks are ignored.
+  */
+
+  void discard_chunks(size_t from, cdk::Reply *last)
+  {
+    for (size_t pos = from; pos < m_chunks.size(); ++pos)
+    {
+      try { m_chunks[pos]->discard(); }
+      catch (...) {}
+    }
+
+    if (last)
+    {
+      try { last->discard(); }
+      catch (...) {}
+    }
+  }
+
+  /*
+    Release replies of the earlier chunks, to be owned by the result.
+  */
+
+  std::vector<cdk::Reply*> release_chunks()
+  {
+    std::vector<cdk::Reply*> chunks;
+    for (auto &r : m_chunks)
+      chunks.push_back(r.release());
+    m_chunks.clear();
+    return chunks;
+  }
+
+
   // Async execution
 
   bool m_inited = false;
   bool m_completed = false;
 
+  /*
+    Reset execution state so that the operation can be sent to the server
+    again. Derived classes that keep state related to a single execution
+    can overwrite this method to clear it.
+  */
+
+  virtual void reset()
+  {
+    m_inited = false;
+    m_completed = false;
+    m_reply.reset();
+    m_chunks.clear();
+  }
+
   void init()
   {
     if (m_inited)
@@ -706,13 +1288,20 @@ protected:
 
   // Synchronous execution
 
+  /*
+    Note: an operation can be executed many times. Parse results of
+    expressions used in the operation are kept between executions, so
+    that re-executing it after binding new parameter values does not
+    need to parse these expressions again.
+  */
+
   internal::BaseResult execute()
   {
     // Deregister current Result, before creating a new one
     internal::XSession_base::Access::register_result(*m_sess, NULL);
 
     if (m_completed)
-      THROW("Can not execute operation for the second time");
+      reset();
     return wait();
   }
 
@@ -765,11 +1354,11 @@ class Op_sort
   : public Op_base<Impl>
   , public cdk::Order_by
 {
-  std::list<cdk::string> m_order;
+  std::list<Parsed_order> m_order;
 
   void add_sort(const mysqlx::string &sort)
   {
-    m_order.push_back(sort);
+    m_order.emplace_back(PM, sort);
   }
 
 protected:
@@ -798,12 +1387,9 @@ private:
   {
     prc.list_begin();
 
-    for (cdk::string el : m_order)
+    for (const Parsed_order &el : m_order)
     {
-
-      parser::Order_parser order_parser(PM, el);
-      order_parser.process_if(prc.list_el());
-
+      el.process_if(prc.list_el());
     }
 
     prc.list_end();
@@ -832,11 +1418,11 @@ class Op_having
   : public Op_sort<Impl, PM>
   , public cdk::Expression
 {
-  cdk::string m_having;
+  Parsed_expr m_having;
 
   void set_having(const mysqlx::string &having)
   {
-    m_having = having;
+    m_having = Parsed_expr(PM, having);
   }
 
 protected:
@@ -862,8 +1448,7 @@ private:
 
   void process(cdk::Expression::  Processor& prc) const
   {
-    parser::Expression_parser expr_parser(PM, m_having);
-    expr_parser.process(prc);
+    m_having.process(prc);
   }
 };
 
@@ -889,11 +1474,11 @@ class Op_group_by
   : public Op_having<Impl, PM>
   , public cdk::Expr_list
 {
-  std::vector<cdk::string> m_group_by;
+  std::vector<Parsed_expr> m_group_by;
 
   void add_group_by(const mysqlx::string &group_by)
   {
-    m_group_by.push_back(group_by);
+    m_group_by.emplace_back(PM, group_by);
   }
 
 protected:
@@ -919,10 +1504,9 @@ private:
   {
     prc.list_begin();
 
-    for (cdk::string el : m_group_by)
+    for (const Parsed_expr &el : m_group_by)
     {
-      parser::Expression_parser expr_parser(PM, el);
-      expr_parser.process_if(prc.list_el());
+      el.process_if(prc.list_el());
     }
 
     prc.list_end();
@@ -954,8 +1538,8 @@ class Op_projection
     , public cdk::Expression::Document
 {
 
-  std::vector<cdk::string> m_projections;
-  cdk::string  m_doc_proj;
+  std::vector<Parsed_projection> m_projections;
+  Parsed_expr  m_doc_proj;
 
 protected:
 
@@ -972,12 +1556,12 @@ public:
 
   void set_proj(const mysqlx::string& doc)
   {
-    m_doc_proj = doc;
+    m_doc_proj = Parsed_expr(parser::Parser_mode::DOCUMENT, doc);
   }
 
   void add_proj(const mysqlx::string& field)
   {
-    m_projections.push_back(field);
+    m_projections.emplace_back(PM, field);
   }
 
   cdk::Projection* get_tbl_proj()
@@ -1024,19 +1608,16 @@ private:
 
       eprc.m_prc = &prc;
 
-      parser::Expression_parser parser(parser::Parser_mode::DOCUMENT, m_doc_proj);
-
-      parser.process(eprc);
+      m_doc_proj.process(eprc);
 
       return;
     }
 
     prc.doc_begin();
 
-    for (cdk::string field : m_projections)
+    for (const Parsed_projection &field : m_projections)
     {
-      parser::Projection_parser expr_parser(PM, field);
-      expr_parser.process(prc);
+      field.process(prc);
     }
 
     prc.doc_end();
@@ -1047,14 +1628,11 @@ private:
   {
     prc.list_begin();
 
-    for (cdk::string el : m_projections)
+    for (const Parsed_projection &el : m_projections)
     {
-
-      parser::Projection_parser order_parser(PM, el);
       auto prc_el = prc.list_el();
       if (prc_el)
-        order_parser.process(*prc_el);
-
+        el.process(*prc_el);
     }
 
     prc.list_end();
@@ -1084,8 +1662,7 @@ class Op_select : public Base
 {
 protected:
 
-  mysqlx::string m_where_expr;
-  std::unique_ptr<parser::Expression_parser> m_expr;
+  Parsed_expr m_where;
 
   template <class X,
             typename std::enable_if<
@@ -1095,26 +1672,16 @@ protected:
   Op_select(X &init) : Base(init)
   {}
 
-  Op_select(const Op_select &other)
-    : Base(other)
-    , m_where_expr(other.m_where_expr)
-  {
-    if (!m_where_expr.empty())
-      m_expr.reset(new parser::Expression_parser(PM, m_where_expr));
-  }
-
 public:
 
   void add_where(const mysqlx::string &expr)
   {
-    m_where_expr = expr;
-    if (!m_where_expr.empty())
-      m_expr.reset(new parser::Expression_parser(PM, m_where_expr));
+    m_where = Parsed_expr(PM, expr);
   }
 
-  cdk::Expression* get_where() const
+  cdk::Expression* get_where()
   {
-    return m_expr.get();
+    return m_where.empty() ? nullptr : &m_where;
   }
 };
 
@@ -28,6 +28,7 @@
 #include "impl.h"
 
 #include <vector>
+#include <deque>
 #include <sstream>
 #include <iomanip>
 #include <cctype>
@@ -55,31 +56,6 @@ public:
 };
 
 
-/*
-  Convenience wrapper around std container that is used
-  to store incoming raw bytes sequence.
-*/
-
-class Buffer
-{
-  std::vector<byte> m_impl;
-
-public:
-
-  void append(bytes data)
-  {
-    m_impl.insert(m_impl.end(), data.begin(), data.end());
-  }
-
-  size_t size() const { return m_impl.size(); }
-
-  cdk::bytes data() const
-  {
-    return cdk::bytes((byte*)m_impl.data(), m_impl.size());
-  }
-};
-
-
 /*
   Handling column meta-data information
   =====================================
@@ -178,22 +154,6 @@ template <>
 struct Format_descr<cdk::TYPE_BYTES>
 {};
 
-/*
-  Note: we do not decode temporal values yet, thus there is
-  no codec in Format_descr class.
-*/
-
-template<>
-struct Format_descr<cdk::TYPE_DATETIME>
-{
-  cdk::Format<cdk::TYPE_DATETIME> m_format;
-
-  Format_descr(const cdk::Format_info &fi)
-    : m_format(fi)
-  {}
-};
-
-
 /*
   Note: For GEOMETRY and XML types we do not decode the values.
   Also, CDK does not provide any encoding format information -
@@ -699,11 +659,88 @@ CDK_CS_LIST(COLL_DEFS)
 */
 
 /*
-  Data structure used to hold raw row data. It holds a Buffer with
-  raw bytes for each non-null field of a row.
+  Data structure used to hold raw row data. Raw bytes of all fields
+  of a row are stored in a single buffer and for each field there is
+  an entry in m_fields array which gives its location within the buffer.
+  NULL fields (and fields for which no data was received) have m_begin
+  set to null_pos.
+
+  Fields are filled using begin_field() and append() calls. It is assumed
+  that all data for one field is appended before the next field begins.
 */
 
-typedef std::map<col_count_t, Buffer> Row_data;
+class Row_data
+{
+  static const size_t null_pos = static_cast<size_t>(-1);
+
+  struct Field
+  {
+    size_t m_begin = null_pos;
+    size_t m_end = 0;
+  };
+
+  std::vector<byte>  m_buf;
+  std::vector<Field> m_fields;
+
+public:
+
+  void clear()
+  {
+    m_buf.clear();
+    m_fields.clear();
+  }
+
+  void reserve(col_count_t col_count)
+  {
+    m_fields.reserve(col_count);
+  }
+
+  col_count_t size() const
+  {
+    return (col_count_t)m_fields.size();
+  }
+
+  void begin_field(col_count_t pos)
+  {
+    if (pos >= m_fields.size())
+      m_fields.resize(pos + 1);
+
+    Field &fld = m_fields[pos];
+    fld.m_begin = fld.m_end = m_buf.size();
+  }
+
+  void append(col_count_t pos, bytes data)
+  {
+    Field &fld = m_fields.at(pos);
+    assert(fld.m_end == m_buf.size());
+    m_buf.insert(m_buf.end(), data.begin(), data.end());
+    fld.m_end = m_buf.size();
+  }
+
+  /*
+    Returns true if field at given position is NULL or does not exist.
+  */
+
+  bool is_null(col_count_t pos) const
+  {
+    return pos >= m_fields.size() || null_pos == m_fields[pos].m_begin;
+  }
+
+  /*
+    Get raw bytes of the field at given position.
+    @throws std::out_of_range if the field is NULL or does not exist.
+  */
+
+  cdk::bytes at(col_count_t pos) const
+  {
+    if (is_null(pos))
+      throw std::out_of_range("Row_data: NULL field");
+
+    const Field &fld = m_fields[pos];
+    return cdk::bytes((byte*)m_buf.data() + fld.m_begin,
+                      fld.m_end - fld.m_begin);
+  }
+};
 
 
 /*
@@ -719,25 +756,55 @@ class Row::Impl
 public:
 
   Impl() {}
-  Impl(const Row_data&, std::shared_ptr<Meta_data>&);
+  Impl(Row_data&&, std::shared_ptr<Meta_data>&);
 
 private:
 
   Row_data m_data;
   std::shared_ptr<Meta_data> m_mdata;
-  std::map<col_count_t, Value> m_vals;
   col_count_t m_col_count = 0;
 
+  /*
+    Values of fields which were already decoded (or set by user).
+    Flag m_has_val[pos] tells if m_vals[pos] holds a valid value.
+
+    Note: Row::get() and Row::set() return references to the stored values.
+    A deque is used so that these references remain valid when the row is
+    extended by setting a value past its current end.
+  */
+
+  std::deque<Value>  m_vals;
+  std::vector<bool>  m_has_val;
+
   void clear()
   {
     m_data.clear();
     m_vals.clear();
+    m_has_val.clear();
     m_mdata.reset();
   }
 
+  bool has_value(col_count_t pos) const
+  {
+    return pos < m_has_val.size() && m_has_val[pos];
+  }
+
+  Value& set_value(col_count_t pos, const Value &val)
+  {
+    if (pos >= m_vals.size())
+    {
+      m_vals.resize(pos + 1);
+      m_has_val.resize(pos + 1, false);
+    }
+
+    m_vals[pos] = val;
+    m_has_val[pos] = true;
+    return m_vals[pos];
+  }
+
   bytes get_bytes(col_count_t pos) const
   {
-    return mysqlx::bytes::Access::mk(m_data.at(pos).data());
+    return mysqlx::bytes::Access::mk(m_data.at(pos));
   }
 
   /*
@@ -749,13 +816,30 @@ private:
   Value& get(col_count_t pos)
   {
     const Format_info &fi = m_mdata->get_format(pos);
+    return set_value(pos, convert(m_data.at(pos), fi.get<T>()));
+  }
+
+
+  /*
+    Decode field at given position, which must be of CDK type T, using
+    the codec for that type.
+    @throws std::out_of_range if given column does not exist in the row.
+  */
+
+  template<cdk::Type_info T, typename V>
+  void decode(col_count_t pos, V &val) const
+  {
+    if (!m_mdata || pos >= m_mdata->col_count())
+      throw std::out_of_range("Row: no field at given position");
 
-    m_vals.emplace(
-      pos,
-      convert(m_data.at(pos).data(), fi.get<T>())
-    );
+    if (T != m_mdata->get_type(pos))
+      throw Error("Row: field is not of requested type");
 
-    return m_vals.at(pos);
+    if (m_data.is_null(pos))
+      throw Error("Row: field is NULL");
+
+    const Format_info &fi = m_mdata->get_format(pos);
+    fi.get<T>().m_codec.from_bytes(m_data.at(pos), val);
   }
 
 
@@ -767,14 +851,50 @@ private:
 
   friend Row;
   friend RowResult;
+  friend RowList;
   friend SqlResult;
 };
 
 
-// Note: row data is copied
+/*
+  Storage for rows returned by RowResult::fetchMany(). Row instances
+  returned from a RowList share ownership of this storage.
+*/
+
+class RowList::Impl
+{
+  std::vector<Row::Impl> m_rows;
+
+  friend RowList;
+  friend RowResult;
+};
+
+
+size_t RowList::size() const
+{
+  return m_impl ? m_impl->m_rows.size() : 0;
+}
+
+
+Row RowList::operator[](size_t pos) const
+{
+  if (pos >= size())
+    throw out_of_range("RowList: no row at given position");
+
+  // Note: the returned row shares ownership of the whole list.
+
+  return Row(std::shared_ptr<Row::Impl>(m_impl, &m_impl->m_rows[pos]));
+}
 
-Row::Impl::Impl(const Row_data &data, std::shared_ptr<Meta_data> &mdata)
-  : m_data(data), m_mdata(mdata)
+
+/*
+  Note: row data is moved into the Row instance. Arrays of decoded values
+  are not allocated here - they grow in set_value() when fields are
+  accessed.
+*/
+
+Row::Impl::Impl(Row_data &&data, std::shared_ptr<Meta_data> &mdata)
+  : m_data(std::move(data)), m_mdata(mdata)
 {}
 
 
@@ -822,18 +942,25 @@ Value& Row::get(mysqlx::col_count_t pos)
     m_vals array.
   */
 
-  try {
-    return impl.m_vals.at(pos);
-  }
-  catch (const std::out_of_range&)
-  {
-    /*
-      If we have data from server (meta-data is set) then we convert
-      it into the value below - otherwise we throw out_of_range error.
-    */
-    if (!impl.m_mdata)
-      throw;
-  }
+  if (impl.has_value(pos))
+    return impl.m_vals[pos];
+
+  /*
+    If we have data from server (meta-data is set) then we convert
+    it into the value below - otherwise we throw out_of_range error.
+  */
+
+  if (!impl.m_mdata)
+    throw std::out_of_range("Row::get(): no value at given position");
+
+  /*
+    NULL fields, as well as fields past the end of the row data, are
+    stored as NULL values. This is checked using the null bitmap so that
+    no exception is thrown in this common case.
+  */
+
+  if (impl.m_data.is_null(pos))
+    return set(pos, Value());
 
   /*
     We have data from server - convert it into a value and store
@@ -842,48 +969,184 @@ Value& Row::get(mysqlx::col_count_t pos)
 
   try {
 
-    try {
-      // will throw out_of_range exception if column at `pos` is NULL
-      bytes data = getBytes(pos);
+    bytes data = impl.get_bytes(pos);
 
-      switch (impl.m_mdata->get_type(pos))
-      {
-      case cdk::TYPE_STRING:    return impl.get<cdk::TYPE_STRING>(pos);
-      case cdk::TYPE_INTEGER:   return impl.get<cdk::TYPE_INTEGER>(pos);
-      case cdk::TYPE_FLOAT:     return impl.get<cdk::TYPE_FLOAT>(pos);
-      case cdk::TYPE_DOCUMENT:  return impl.get<cdk::TYPE_DOCUMENT>(pos);
+    switch (impl.m_mdata->get_type(pos))
+    {
+    case cdk::TYPE_STRING:    return impl.get<cdk::TYPE_STRING>(pos);
+    case cdk::TYPE_INTEGER:   return impl.get<cdk::TYPE_INTEGER>(pos);
+    case cdk::TYPE_FLOAT:     return impl.get<cdk::TYPE_FLOAT>(pos);
+    case cdk::TYPE_DOCUMENT:  return impl.get<cdk::TYPE_DOCUMENT>(pos);
 
-        /*
-          TODO: Other "natural" conversions
-          TODO: User-defined conversions (also to user-defined types)
-        */
+      /*
+        TODO: Other "natural" conversions
+        TODO: User-defined conversions (also to user-defined types)
+      */
 
-      case cdk::TYPE_BYTES:
+    case cdk::TYPE_BYTES:
 
-        /*
-          Note: in case of raw bytes, we trim the extra 0x00 byte added
-          at the end by the protocol (to handle NULL values).
-        */
+      /*
+        Note: in case of raw bytes, we trim the extra 0x00 byte added
+        at the end by the protocol (to handle NULL values).
+      */
 
-        return set(pos, bytes(data.begin(), data.end() - 1));
+      return set(pos, bytes(data.begin(), data.end() - 1));
 
-      default:
+    default:
 
-        /*
-          For all types for which we do not have a natural conversion
-          to C++ type, we return raw bytes representing the value as
-          returned by protocol.
-        */
+      /*
+        For all types for which we do not have a natural conversion
+        to C++ type, we return raw bytes representing the value as
+        returned by protocol.
+      */
 
-        return set(pos, data);
-      }
-    }
-    catch (std::out_of_range&)
-    {
-      // set to NULL
-      return set(pos, Value());
+      return set(pos, data);
     }
+  }
+  CATCH_AND_WRAP
+}
+
+
+/*
+  Decoded DECIMAL and temporal values
+  -----------------------------------
+*/
+
+Decimal::operator double() const
+{
+  cdk::Decimal val;
+  val.m_val = value;
+  val.m_scale = scale;
+  return val;
+}
+
+
+void Decimal::print(std::ostream &out) const
+{
+  uint64_t abs = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+  std::string digits = std::to_string(abs);
+
+  if (digits.length() <= scale)
+    digits.insert(0, scale + 1 - digits.length(), '0');
+
+  if (value < 0)
+    out << '-';
+  out << digits.substr(0, digits.length() - scale);
+  if (scale > 0)
+    out << '.' << digits.substr(digits.length() - scale);
+}
+
+
+/*
+  Note: Temporal values are formatted in a local stream so that fill and
+  width settings of the output stream are not changed.
+*/
+
+void Datetime::print(std::ostream &out) const
+{
+  std::ostringstream buf;
+  buf << std::setfill('0')
+      << std::setw(4) << year << '-'
+      << std::setw(2) << month << '-'
+      << std::setw(2) << day << ' '
+      << std::setw(2) << hour << ':'
+      << std::setw(2) << minute << ':'
+      << std::setw(2) << second;
+  if (usec > 0)
+    buf << '.' << std::setw(6) << usec;
+  out << buf.str();
+}
+
+
+void Time::print(std::ostream &out) const
+{
+  std::ostringstream buf;
+  if (negative)
+    buf << '-';
+  buf << std::setfill('0')
+      << std::setw(2) << hours << ':'
+      << std::setw(2) << minutes << ':'
+      << std::setw(2) << seconds;
+  if (usec > 0)
+    buf << '.' << std::setw(6) << usec;
+  out << buf.str();
+}
+
+
+Decimal Row::getDecimal(col_count_t pos) const
+{
+  try {
+    cdk::Decimal val;
+    get_impl().decode<cdk::TYPE_FLOAT>(pos, val);
 
+    Decimal ret;
+    ret.value = val.m_val;
+    ret.scale = val.m_scale;
+    return ret;
+  }
+  catch (const std::out_of_range&)
+  {
+    throw;
+  }
+  CATCH_AND_WRAP
+}
+
+
+Datetime Row::getDatetime(col_count_t pos) const
+{
+  try {
+    cdk::Datetime val;
+    get_impl().decode<cdk::TYPE_DATETIME>(pos, val);
+
+    Datetime ret;
+    ret.year = val.m_year;
+    ret.month = val.m_month;
+    ret.day = val.m_day;
+    ret.hour = val.m_hour;
+    ret.minute = val.m_minute;
+    ret.second = val.m_second;
+    ret.usec = val.m_usec;
+    return ret;
+  }
+  catch (const std::out_of_range&)
+  {
+    throw;
+  }
+  CATCH_AND_WRAP
+}
+
+
+Time Row::getTime(col_count_t pos) const
+{
+  try {
+    cdk::Time val;
+    get_impl().decode<cdk::TYPE_DATETIME>(pos, val);
+
+    Time ret;
+    ret.negative = val.m_negative;
+    ret.hours = val.m_hours;
+    ret.minutes = val.m_minutes;
+    ret.seconds = val.m_seconds;
+    ret.usec = val.m_usec;
+    return ret;
+  }
+  catch (const std::out_of_range&)
+  {
+    throw;
+  }
+  CATCH_AND_WRAP
+}
+
+
+bool Row::isNull(col_count_t pos) const
+{
+  try {
+    const Impl &impl = get_impl();
+
+    if (impl.has_value(pos))
+      return impl.m_vals[pos].isNull();
+
+    return !impl.m_mdata || impl.m_data.is_null(pos);
   }
   CATCH_AND_WRAP
 }
@@ -897,12 +1160,10 @@ Value& Row::set(col_count_t pos, const Value &val)
 
     Impl &impl = get_impl();
 
-    impl.m_vals.emplace(pos, val);
-
     if (pos + 1 > impl.m_col_count)
       impl.m_col_count = pos + 1;
 
-    return impl.m_vals.at(pos);
+    return impl.set_value(pos, val);
   }
   CATCH_AND_WRAP
 }
@@ -941,6 +1202,21 @@ Row::Impl::convert(cdk::bytes data, Format_descr<cdk::TYPE_STRING> &fd) const
   if (fd.m_format.is_set())
     return Value(bytes(raw.begin(), raw.end()));
 
+  /*
+    Strings in utf8 and utf8mb4 character sets are stored in UTF-8 form
+    as received from the server. They are converted to wide strings
+    only if user requests that.
+  */
+
+  switch (fd.m_format.charset())
+  {
+  case cdk::Charset::utf8:
+  case cdk::Charset::utf8mb4:
+    return Value::Access::mk_utf8(std::string(raw.begin(), raw.end()));
+  default:
+    break;
+  }
+
   auto &codec = fd.m_codec;
   cdk::string str;
   codec.from_bytes(raw, str);
@@ -974,8 +1250,6 @@ Row::Impl::convert(cdk::bytes data, Format_descr<cdk::TYPE_FLOAT> &fd) const
 {
   auto &fmt = fd.m_format;
 
-  // Note: DECIMAL format not yet supported by CDK
-
   if (fmt.FLOAT == fmt.type())
   {
     float val;
@@ -990,6 +1264,12 @@ Row::Impl::convert(cdk::bytes data, Format_descr<cdk::TYPE_FLOAT> &fd) const
     return Value(val);
   }
 
+  /*
+    Note: DECIMAL values are returned as raw bytes - converting them
+    to DOUBLE could loose precision and Value does not have
+    a fixed-point type.
+  */
+
   return bytes(data.begin(), data.end());
 }
 
@@ -1034,11 +1314,31 @@ class internal::BaseResult::Impl
 {
   cdk::Reply  *m_reply = NULL;
   cdk::Cursor *m_cursor = NULL;
+
+  /*
+    If insert operation was sent in several chunks, m_reply is the reply
+    for the last chunk and replies for earlier chunks, which are already
+    completed, are stored here. Affected rows count and warnings reported
+    by the result are collected from all these replies.
+  */
+
+  std::vector<cdk::Reply*>    m_chunks;
+
   Row_data     m_row;
   std::shared_ptr<Meta_data>  m_mdata;
   std::vector<GUID>           m_guid;
   bool                        m_cursor_closed = false;
 
+  /*
+    Rows are read from the cursor in batches of m_fetch_size rows and
+    stored in m_rows queue from which get_row() takes them one by one.
+  */
+
+  static const row_count_t    default_fetch_size = 32;
+
+  std::deque<Row_data>        m_rows;
+  row_count_t                 m_fetch_size = default_fetch_size;
+
   Impl(cdk::Reply *r)
     : m_reply(r)
   {
@@ -1051,6 +1351,13 @@ class internal::BaseResult::Impl
     init();
   }
 
+  Impl(cdk::Reply *r, const std::vector<GUID> &guids,
+       const std::vector<cdk::Reply*> &chunks)
+    : m_reply(r), m_chunks(chunks), m_guid(guids)
+  {
+    init();
+  }
+
   void init()
   {
     if (!m_reply)
@@ -1065,6 +1372,7 @@ class internal::BaseResult::Impl
     {
       delete m_cursor;
       m_cursor_closed = false;
+      m_rows.clear();
       m_cursor = new cdk::Cursor(*m_reply);
       m_cursor->wait();
       // copy meta-data information from cursor
@@ -1094,6 +1402,14 @@ class internal::BaseResult::Impl
     // Note: Cursor must be deleted before reply.
     delete m_cursor;
     delete m_reply;
+    delete_chunks();
+  }
+
+  void delete_chunks()
+  {
+    for (cdk::Reply *r : m_chunks)
+      delete r;
+    m_chunks.clear();
   }
 
   /*
@@ -1109,6 +1425,7 @@ class internal::BaseResult::Impl
 
     delete m_reply;
     m_reply = NULL;
+    delete_chunks();
   }
 
   /*
@@ -1116,20 +1433,43 @@ class internal::BaseResult::Impl
     more rows. Throws exeption if this result has no data.
   */
 
-  const Row_data *get_row();
+  Row_data *get_row();
+
+  /*
+    Read next batch of rows from the cursor into m_rows queue. Returns
+    false if there are no more rows.
+  */
+
+  bool fetch_rows();
+
+  void set_fetch_size(row_count_t size)
+  {
+    m_fetch_size = size > 0 ? size : 1;
+  }
 
 
   cdk::row_count_t get_affected_rows() const
   {
     if (!m_reply)
       THROW("Attempt to get affected rows count on empty result");
-    return m_reply->affected_rows();
+
+    cdk::row_count_t count = m_reply->affected_rows();
+    for (cdk::Reply *r : m_chunks)
+      count += r->affected_rows();
+    return count;
   }
 
+  /*
+    Note: For chunked insert this is the value generated for the first
+    chunk, same as for a single insert of many rows.
+  */
+
   cdk::row_count_t get_auto_increment() const
   {
     if (!m_reply)
       THROW("Attempt to get auto increment value on empty result");
+    if (!m_chunks.empty())
+      return m_chunks.front()->last_insert_id();
     return m_reply->last_insert_id();
   }
 
@@ -1138,7 +1478,11 @@ class internal::BaseResult::Impl
     if (!m_reply)
       THROW("Attempt to get warning count for empty result");
     const_cast<Impl*>(this)->load_warnings();
-    return m_reply->entry_count(cdk::api::Severity::WARNING);
+
+    unsigned count = m_reply->entry_count(cdk::api::Severity::WARNING);
+    for (cdk::Reply *r : m_chunks)
+      count += r->entry_count(cdk::api::Severity::WARNING);
+    return count;
   }
 
   std::vector<Warning> m_warnings;
@@ -1150,13 +1494,16 @@ class internal::BaseResult::Impl
   }
 
   void load_warnings();
+  void load_warnings(cdk::Reply&);
 
 
   // Row_processor
 
   bool row_begin(row_count_t)
   {
-    m_row.clear();
+    m_rows.emplace_back();
+    if (m_mdata)
+      m_rows.back().reserve(m_mdata->col_count());
     return true;
   }
   void row_end(row_count_t) {}
@@ -1174,37 +1521,54 @@ class internal::BaseResult::Impl
 };
 
 
-const Row_data* Result::Impl::get_row()
+Row_data* Result::Impl::get_row()
 {
   if (!m_cursor)
     THROW("Attempt to read row from empty result");
 
-  if (m_cursor_closed)
+  if (m_rows.empty() && !fetch_rows())
     return NULL;
 
+  m_row = std::move(m_rows.front());
+  m_rows.pop_front();
+
+  return &m_row;
+}
+
+
+bool Result::Impl::fetch_rows()
+{
+  if (m_cursor_closed)
+    return false;
+
+  m_cursor->get_rows(*this, m_fetch_size);
+  m_cursor->wait();
+
   /*
-    TODO: Row cache for better I/O performance (read several rows at once)
+    If cursor returned less rows than requested, all rows have been
+    read and the cursor can be closed.
   */
-  if (m_cursor->get_row(*this))
-    return &m_row;
 
-  m_cursor->close();
-  m_cursor_closed = true;
+  if (m_rows.size() < m_fetch_size)
+  {
+    m_cursor->close();
+    m_cursor_closed = true;
+  }
 
-  return NULL;
+  return !m_rows.empty();
 }
 
 
 size_t Result::Impl::field_begin(col_count_t pos, size_t size)
 {
-  m_row.insert(std::pair<col_count_t, Buffer>(pos, Buffer()));
+  m_rows.back().begin_field(pos);
   // FIX
   return size;
 }
 
 size_t Result::Impl::field_data(col_count_t pos, bytes data)
 {
-  m_row[(unsigned)pos].append(mysqlx::bytes::Access::mk(data));
+  m_rows.back().append(pos, mysqlx::bytes::Access::mk(data));
   // FIX
   return data.size();
 }
@@ -1248,7 +1612,19 @@ void Result::Impl::load_warnings()
 
   m_warnings.clear();
 
-  auto &it = m_reply->get_entries(cdk::api::Severity::WARNING);
+  for (cdk::Reply *r : m_chunks)
+    load_warnings(*r);
+  load_warnings(*m_reply);
+}
+
+
+/*
+  Append warnings reported in the given reply to m_warnings.
+*/
+
+void Result::Impl::load_warnings(cdk::Reply &reply)
+{
+  auto &it = reply.get_entries(cdk::api::Severity::WARNING);
 
   while (it.next())
   {
@@ -1312,6 +1688,21 @@ internal::BaseResult::BaseResult(XSession_base *sess,
 }
 
 
+internal::BaseResult::BaseResult(XSession_base *sess,
+                                 cdk::Reply *r,
+                                 const std::vector<GUID> &guids,
+                                 const std::vector<cdk::Reply*> &chunks)
+{
+  try {
+    m_owns_impl = true;
+    m_impl= new Impl(r, guids, chunks);
+    m_sess = sess;
+    m_sess->register_result(this);
+  }
+  CATCH_AND_WRAP
+}
+
+
 internal::BaseResult::~BaseResult()
 {
   try {
@@ -1475,16 +1866,59 @@ Row RowResult::fetchOne()
   }
   try {
     Impl &impl = get_impl();
-    const Row_data *row = impl.get_row();
+    Row_data *row = impl.get_row();
 
     if (!row)
       return Row();
 
-    return Row(std::make_shared<Row::Impl>(*row, impl.m_mdata));
+    return Row(std::make_shared<Row::Impl>(std::move(*row), impl.m_mdata));
+  }
+  CATCH_AND_WRAP
+}
+
+RowList RowResult::fetchMany(row_count_t count)
+{
+  try {
+
+    RowList list;
+    list.m_impl = std::make_shared<RowList::Impl>();
+    std::vector<Row::Impl> &rows = list.m_impl->m_rows;
+
+    // If rows were cached by count(), take them from the cache.
+
+    if (m_cache)
+    {
+      while (rows.size() < count && m_row_cache_size > 0)
+      {
+        rows.push_back(m_row_cache.front().get_impl());
+        m_row_cache.pop_front();
+        m_row_cache_size--;
+      }
+      return list;
+    }
+
+    Impl &impl = get_impl();
+
+    while (rows.size() < count)
+    {
+      Row_data *row = impl.get_row();
+      if (!row)
+        break;
+      rows.emplace_back(std::move(*row), impl.m_mdata);
+    }
+
+    return list;
   }
   CATCH_AND_WRAP
 }
 
+
+RowList RowResult::fetchAll()
+{
+  return fetchMany(std::numeric_limits<row_count_t>::max());
+}
+
+
 uint64_t RowResult::count()
 {
   if (!m_cache)
@@ -1495,13 +1929,13 @@ uint64_t RowResult::count()
 
     auto it = m_row_cache.before_begin();
 
-    for(const Row_data *row = impl.get_row();
+    for(Row_data *row = impl.get_row();
         row != nullptr;
         row = impl.get_row())
     {
       ++m_row_cache_size;
       it = m_row_cache.insert_after(it,
-                                    Row(std::make_shared<Row::Impl>(*row,
+                                    Row(std::make_shared<Row::Impl>(std::move(*row),
                                                                     impl.m_mdata)
                                         )
                                     );
@@ -1513,6 +1947,15 @@ uint64_t RowResult::count()
 }
 
 
+void RowResult::setFetchSize(row_count_t size)
+{
+  try {
+    get_impl().set_fetch_size(size);
+  }
+  CATCH_AND_WRAP
+}
+
+
 void RowResult::check_result() const
 {
   if (!get_impl().m_cursor)
@@ -1608,6 +2051,59 @@ DbDoc DocResult::fetchOne()
   CATCH_AND_WRAP
 }
 
+DocList DocResult::fetchMany(row_count_t count)
+{
+  try {
+    check_result();
+
+    DocList list;
+    list.m_impl = std::make_shared<DocList::Impl>();
+    auto &docs = list.m_impl->m_docs;
+
+    /*
+      Rows are taken one by one so that row data can be released as soon
+      as the document is built from it. The JSON string is moved into the
+      document, so that document data is copied only once.
+    */
+
+    while (docs.size() < count)
+    {
+      Row row = m_doc_impl->fetchOne();
+      if (!row)
+        break;
+      bytes data = row.getBytes(0);
+      docs.emplace_back(std::string(data.begin(), data.end() - 1));
+    }
+
+    return list;
+  }
+  CATCH_AND_WRAP
+}
+
+
+DocList DocResult::fetchAll()
+{
+  return fetchMany(std::numeric_limits<row_count_t>::max());
+}
+
+
+size_t DocList::size() const
+{
+  return m_impl ? m_impl->m_docs.size() : 0;
+}
+
+
+DbDoc DocList::operator[](size_t pos) const
+{
+  if (pos >= size())
+    throw out_of_range("DocList: no document at given position");
+
+  // Note: the returned document shares ownership of the whole list.
+
+  return DbDoc(std::shared_ptr<DbDoc::Impl>(m_impl, &m_impl->m_docs[pos]));
+}
+
+
 uint64_t DocResult::count()
 {
   return m_doc_impl->count_docs();
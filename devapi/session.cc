@@ -29,6 +29,13 @@
 #include <iostream>
 #include <sstream>
 #include <list>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include "impl.h"
 
@@ -37,9 +44,10 @@ using namespace ::mysqlx;
 
 struct Endpoint
 {
-  enum Type { TCPIP };
+  enum Type { TCPIP, UNIX_SOCKET };
 
   virtual Type type() const = 0;
+  virtual ~Endpoint() {}
 };
 
 
@@ -96,13 +104,34 @@ namespace endpoint {
     uint16_t    m_port;
   };
 
+
+  struct Unix_socket
+    : public Endpoint
+  {
+    Type type() const { return Endpoint::UNIX_SOCKET; }
+    virtual std::string path()
+    {
+      return m_path;
+    }
+
+    Unix_socket(const std::string &path)
+      : m_path(path)
+    {}
+
+  protected:
+
+    std::string m_path;
+  };
+
 } // endpoint
 
 
 
 class internal::XSession_base::Impl
 {
-  cdk::ds::TCPIP   m_ds;
+  typedef std::chrono::steady_clock clock;
+
+  XSession_base::Options m_opt;
   cdk::Session     m_sess;
   cdk::string      m_default_db;
 
@@ -110,20 +139,464 @@ class internal::XSession_base::Impl
 
   internal::BaseResult *m_current_result = NULL;
 
+  /*
+    Pool from which this session was taken, if any. It is set only while
+    the session is in use - idle sessions stored in the pool do not keep
+    a reference to it.
+  */
+
+  std::shared_ptr<SessionPool::Impl> m_pool;
+  clock::time_point m_created = clock::now();
+
   Impl(endpoint::TCPIP &ep, XSession_base::Options &opt)
-    : m_ds(ep.host(), ep.port())
-    , m_sess(m_ds, opt)
+    : m_opt(opt)
+    , m_sess(cdk::ds::TCPIP(ep.host(), ep.port()), opt)
+  {
+    init(opt);
+  }
+
+  Impl(endpoint::Unix_socket &ep, XSession_base::Options &opt)
+    : m_opt(opt)
+    , m_sess(cdk::ds::Unix_socket(ep.path()), opt)
+  {
+    init(opt);
+  }
+
+  void init(XSession_base::Options &opt)
   {
     if (opt.database())
+    {
       m_default_db = *opt.database();
+      m_opt.set_database(m_default_db);
+    }
     if (!m_sess.is_valid())
       m_sess.get_error().rethrow();
   }
 
+  /*
+    Create implementation of a session specified by given settings.
+  */
+
+  static Impl* create(SessionSettings &settings);
+
+  /*
+    Create implementation of a session connected to the given end-point.
+  */
+
+  static Impl* create(Endpoint &ep, XSession_base::Options &opt)
+  {
+    switch (ep.type())
+    {
+    case Endpoint::UNIX_SOCKET:
+      return new Impl(static_cast<endpoint::Unix_socket&>(ep), opt);
+    case Endpoint::TCPIP:
+    default:
+      return new Impl(static_cast<endpoint::TCPIP&>(ep), opt);
+    }
+  }
+
+  /*
+    Bring session to its initial state so that it can be re-used,
+    without opening a new connection.
+  */
+
+  void reset()
+  {
+    m_current_result = NULL;
+    m_sess.reset(m_opt);
+  }
+
   friend XSession_base;
+  friend SessionPool;
 };
 
 
+/*
+  Implementation of session pool.
+
+  Idle sessions are kept in m_idle list, ordered by the time they were
+  returned to the pool (most recently returned at the back). Sessions are
+  taken from the back of the list so that the least recently used ones
+  can time out. Sessions are opened and closed outside of the critical
+  section, to not block other threads during network round-trips.
+
+  A reaper thread periodically closes idle sessions which timed out or
+  expired and opens new ones to keep at least m_min_size sessions in
+  the pool. Sessions being opened by the reaper are counted in m_opening.
+*/
+
+class SessionPool::Impl
+  : public std::enable_shared_from_this<SessionPool::Impl>
+{
+  typedef internal::XSession_base::Impl Session_impl;
+  typedef std::chrono::steady_clock clock;
+
+  struct Entry
+  {
+    Session_impl     *m_sess;
+    clock::time_point m_returned;
+  };
+
+  SessionSettings m_settings;
+  unsigned m_max_size;
+  unsigned m_min_size;
+  clock::duration m_idle_timeout;
+  clock::duration m_max_lifetime;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::deque<Entry> m_idle;
+  unsigned m_in_use = 0;
+  unsigned m_opening = 0;
+  bool m_closed = false;
+
+  std::condition_variable m_reaper_cond;
+  std::thread m_reaper;
+
+public:
+
+  Impl(SessionSettings &settings,
+       unsigned max_size, unsigned min_size,
+       unsigned long idle_timeout, unsigned long max_lifetime)
+    : m_settings(settings)
+    , m_max_size(max_size)
+    , m_min_size(min_size)
+    , m_idle_timeout(std::chrono::milliseconds(idle_timeout))
+    , m_max_lifetime(std::chrono::milliseconds(max_lifetime))
+  {}
+
+  ~Impl()
+  {
+    try {
+      close();
+    }
+    catch (...)
+    {}
+  }
+
+  void open(unsigned count);
+  void start_reaper();
+  Session_impl* get();
+  void release(Session_impl*);
+  void close();
+
+private:
+
+  bool is_expired(Session_impl *sess, clock::time_point now)
+  {
+    return m_max_lifetime != clock::duration::zero()
+           && now - sess->m_created > m_max_lifetime;
+  }
+
+  // Number of sessions owned by the pool. Must be called with m_mutex locked.
+
+  size_t size() const
+  {
+    return m_in_use + m_opening + m_idle.size();
+  }
+
+  void remove_expired(std::vector<Session_impl*>&);
+  void close_sessions(std::vector<Session_impl*>&);
+  void reap();
+};
+
+
+/*
+  Open given number of sessions and store them in the pool.
+*/
+
+void SessionPool::Impl::open(unsigned count)
+{
+  for (unsigned i = 0; i < count; ++i)
+  {
+    Entry entry = { Session_impl::create(m_settings), clock::now() };
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idle.push_back(entry);
+  }
+}
+
+
+/*
+  Move idle sessions which should be closed to the given list. Must be
+  called with m_mutex locked.
+*/
+
+void SessionPool::Impl::remove_expired(std::vector<Session_impl*> &expired)
+{
+  clock::time_point now = clock::now();
+
+  for (auto it = m_idle.begin(); it != m_idle.end();)
+  {
+    bool idle = m_idle_timeout != clock::duration::zero()
+                && now - it->m_returned > m_idle_timeout
+                && size() > m_min_size;
+
+    if (idle || is_expired(it->m_sess, now))
+    {
+      expired.push_back(it->m_sess);
+      it = m_idle.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+
+void SessionPool::Impl::close_sessions(std::vector<Session_impl*> &sessions)
+{
+  for (Session_impl *sess : sessions)
+  {
+    try {
+      sess->m_sess.close();
+    }
+    catch (...)
+    {}
+    delete sess;
+  }
+  sessions.clear();
+}
+
+
+/*
+  Get a session from the pool. If there are no idle sessions and
+  the pool is not full, a new session is opened. Otherwise this call
+  blocks until some other session is returned to the pool.
+
+  An idle session is checked with a round-trip to the server before it
+  is handed out, because its connection could have been closed by
+  the server (or network) while it was waiting in the pool. Sessions
+  which fail the check are closed and another one is taken.
+*/
+
+internal::XSession_base::Impl* SessionPool::Impl::get()
+{
+  std::vector<Session_impl*> expired;
+
+  for (;;)
+  {
+    Session_impl *sess = NULL;
+    bool create = false;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      while (!m_closed)
+      {
+        remove_expired(expired);
+
+        if (!m_idle.empty())
+        {
+          sess = m_idle.back().m_sess;
+          m_idle.pop_back();
+          m_in_use++;
+          break;
+        }
+
+        if (size() < m_max_size)
+        {
+          m_in_use++;
+          create = true;
+          break;
+        }
+
+        m_cond.wait(lock);
+      }
+    }
+
+    close_sessions(expired);
+
+    if (!sess && !create)
+      throw_error("Session pool is closed");
+
+    if (create)
+    try {
+      sess = Session_impl::create(m_settings);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_in_use--;
+      m_cond.notify_one();
+      throw;
+    }
+    else if (!sess->m_sess.check_valid())
+    {
+      expired.push_back(sess);
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_in_use--;
+        m_cond.notify_one();
+      }
+      close_sessions(expired);
+      continue;
+    }
+
+    sess->m_pool = shared_from_this();
+    return sess;
+  }
+}
+
+
+/*
+  Return session to the pool. The session is reset before it can be
+  re-used. If reset fails, the session has expired or the pool is closed,
+  the session is closed instead.
+*/
+
+void SessionPool::Impl::release(Session_impl *sess)
+{
+  bool keep;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    keep = !m_closed && !is_expired(sess, clock::now());
+  }
+
+  if (keep)
+  try {
+    sess->reset();
+  }
+  catch (...)
+  {
+    keep = false;
+  }
+
+  std::vector<Session_impl*> closed;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_in_use--;
+
+    if (keep && !m_closed)
+    {
+      Entry entry = { sess, clock::now() };
+      m_idle.push_back(entry);
+    }
+    else
+      closed.push_back(sess);
+
+    m_cond.notify_one();
+  }
+
+  close_sessions(closed);
+}
+
+
+void SessionPool::Impl::close()
+{
+  std::vector<Session_impl*> idle;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_closed = true;
+
+    for (Entry &entry : m_idle)
+      idle.push_back(entry.m_sess);
+    m_idle.clear();
+
+    m_cond.notify_all();
+    m_reaper_cond.notify_all();
+  }
+
+  if (m_reaper.joinable())
+    m_reaper.join();
+
+  close_sessions(idle);
+}
+
+
+/*
+  Start the reaper thread, if there is any work for it: idle sessions
+  can time out or expire, or the pool should keep some sessions open.
+  The reaper runs once per second, or more often if configured timeouts
+  are shorter.
+*/
+
+void SessionPool::Impl::start_reaper()
+{
+  if (m_idle_timeout == clock::duration::zero()
+      && m_max_lifetime == clock::duration::zero()
+      && 0 == m_min_size)
+    return;
+
+  m_reaper = std::thread(&SessionPool::Impl::reap, this);
+}
+
+
+void SessionPool::Impl::reap()
+{
+  clock::duration period = std::chrono::seconds(1);
+
+  if (m_idle_timeout != clock::duration::zero() && m_idle_timeout < period)
+    period = m_idle_timeout;
+  if (m_max_lifetime != clock::duration::zero() && m_max_lifetime < period)
+    period = m_max_lifetime;
+
+  std::vector<Session_impl*> closed;
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  while (!m_closed)
+  {
+    m_reaper_cond.wait_for(lock, period);
+
+    if (m_closed)
+      break;
+
+    remove_expired(closed);
+
+    unsigned count = 0;
+    if (size() < m_min_size)
+      count = m_min_size - (unsigned)size();
+    m_opening += count;
+
+    lock.unlock();
+
+    close_sessions(closed);
+
+    // Replenish the pool. If the server can not be reached, remaining
+    // sessions are opened in the next round.
+
+    for (; count > 0; --count)
+    {
+      Session_impl *sess = NULL;
+
+      try {
+        sess = Session_impl::create(m_settings);
+      }
+      catch (...)
+      {}
+
+      std::lock_guard<std::mutex> guard(m_mutex);
+
+      m_opening--;
+
+      if (!sess)
+      {
+        m_opening -= count - 1;
+        m_cond.notify_all();
+        break;
+      }
+
+      if (m_closed)
+        closed.push_back(sess);
+      else
+      {
+        Entry entry = { sess, clock::now() };
+        m_idle.push_back(entry);
+      }
+
+      m_cond.notify_one();
+    }
+
+    close_sessions(closed);
+
+    lock.lock();
+  }
+}
+
+
 struct URI_parser
   : public internal::XSession_base::Access::Options
   , private endpoint::TCPIP
@@ -144,8 +617,17 @@ struct URI_parser
   }
 
 
+  /*
+    If socket path was given with `socket=` key, the session connects
+    over Unix domain socket and host/port are ignored.
+  */
+
+  std::unique_ptr<endpoint::Unix_socket> m_socket;
+
   Endpoint& get_endpoint()
   {
+    if (m_socket)
+      return *m_socket;
     return *this;
   }
 
@@ -203,7 +685,12 @@ struct URI_parser
           " without TLS support."
           );
 #endif
-    } else
+    }
+    else if (key == "socket")
+    {
+      m_socket.reset(new endpoint::Unix_socket(val));
+    }
+    else
     {
       std::stringstream err;
       err << "Unexpected key " << key << "=" << val << " on URI";
@@ -214,93 +701,124 @@ struct URI_parser
 };
 
 
-internal::XSession_base::XSession_base(SessionSettings settings)
+internal::XSession_base::Impl*
+internal::XSession_base::Impl::create(SessionSettings &settings)
 {
-  try {
+  if (settings.has_option(SessionSettings::URI))
+  {
+    URI_parser parser(
+          settings[SessionSettings::URI].get<string>()
+        );
 
-    if (settings.has_option(SessionSettings::URI))
-    {
-      URI_parser parser(
-            settings[SessionSettings::URI].get<string>()
-          );
+    return create(parser.get_endpoint(),
+                  static_cast<XSession_base::Options&>(parser));
+  }
+  else
+  {
+    std::string host = "localhost";
+    if (settings.has_option(SessionSettings::HOST))
+      host = settings[SessionSettings::HOST].get<string>();
 
-      m_impl = new Impl(
-                 static_cast<endpoint::TCPIP&>(parser.get_endpoint()),
-                 static_cast<XSession_base::Options&>(parser));
-    }
-    else
-    {
-      std::string host = "localhost";
-      if (settings.has_option(SessionSettings::HOST))
-        host = settings[SessionSettings::HOST].get<string>();
+    unsigned port = DEFAULT_MYSQLX_PORT;
 
-      unsigned port = DEFAULT_MYSQLX_PORT;
+    if (settings.has_option(SessionSettings::PORT))
+      port = settings[SessionSettings::PORT];
 
-      if (settings.has_option(SessionSettings::PORT))
-        port = settings[SessionSettings::PORT];
+    if (port > 65535U)
+      throw_error("Port value out of range");
 
-      if (port > 65535U)
-        throw_error("Port value out of range");
 
+    std::string pwd_str;
+    bool has_pwd = false;
 
-      std::string pwd_str;
-      bool has_pwd = false;
+    if (settings.has_option(SessionSettings::PWD) &&
+        settings[SessionSettings::PWD].isNull() == false)
+    {
+      has_pwd = true;
+      pwd_str = settings[SessionSettings::PWD].get<string>();
+    }
 
-      if (settings.has_option(SessionSettings::PWD) &&
-          settings[SessionSettings::PWD].isNull() == false)
-      {
-        has_pwd = true;
-        pwd_str = settings[SessionSettings::PWD].get<string>();
-      }
+    string user;
 
-      endpoint::TCPIP ep( host, (uint16_t)port);
+    if (settings.has_option(SessionSettings::USER))
+    {
+      user = settings[SessionSettings::USER];
+    }
+    else
+    {
+      throw Error("User not defined!");
+    }
 
-      string user;
+    Options opt(user, has_pwd ? &pwd_str : NULL);
 
-      if (settings.has_option(SessionSettings::USER))
-      {
-        user = settings[SessionSettings::USER];
-      }
-      else
-      {
-        throw Error("User not defined!");
-      }
+    /*
+      Connection over Unix domain socket is local and does not use TLS
+      unless explicitly requested with SSL_ENABLE or SSL_CA.
+    */
 
-      Options opt(user, has_pwd ? &pwd_str : NULL);
+    std::unique_ptr<Endpoint> ep;
 
-      if (settings.has_option(SessionSettings::DB))
-        opt.set_database(
-              settings[SessionSettings::DB].get<string>()
-            );
+    if (settings.has_option(SessionSettings::SOCKET))
+    {
+      ep.reset(new endpoint::Unix_socket(
+                     settings[SessionSettings::SOCKET].get<string>()));
+#ifdef WITH_SSL
+      opt.set_tls(false);
+#endif
+    }
+    else
+      ep.reset(new endpoint::TCPIP(host, (uint16_t)port));
 
-      if (settings.has_option(SessionSettings::SSL_ENABLE) ||
-          settings.has_option(SessionSettings::SSL_CA))
-      {
+    if (settings.has_option(SessionSettings::DB))
+      opt.set_database(
+            settings[SessionSettings::DB].get<string>()
+          );
+
+    if (settings.has_option(SessionSettings::SSL_ENABLE) ||
+        settings.has_option(SessionSettings::SSL_CA))
+    {
 #ifdef WITH_SSL
 
-        //ssl_enable by default, unless SSL_ENABLE = false
-        bool ssl_enable = true;
-        if (settings.has_option(SessionSettings::SSL_ENABLE))
-          ssl_enable = settings[SessionSettings::SSL_ENABLE];
+      //ssl_enable by default, unless SSL_ENABLE = false
+      bool ssl_enable = true;
+      if (settings.has_option(SessionSettings::SSL_ENABLE))
+        ssl_enable = settings[SessionSettings::SSL_ENABLE];
 
-        cdk::connection::TLS::Options opt_ssl(ssl_enable);
+      cdk::connection::TLS::Options opt_ssl(ssl_enable);
 
 
-        if (settings.has_option(SessionSettings::SSL_CA))
-          opt_ssl.set_ca(settings[SessionSettings::SSL_CA].get<string>());
+      if (settings.has_option(SessionSettings::SSL_CA))
+        opt_ssl.set_ca(settings[SessionSettings::SSL_CA].get<string>());
 
-        opt.set_tls(opt_ssl);
+      opt.set_tls(opt_ssl);
 #else
-        throw_error(
-              "Can not create TLS session - this connector is built"
-              " without TLS support."
-              );
+      throw_error(
+            "Can not create TLS session - this connector is built"
+            " without TLS support."
+            );
 #endif
-      }
+    }
 
-      m_impl = new Impl(ep, opt);
+    return create(*ep, opt);
 
-    }
+  }
+}
+
+
+internal::XSession_base::XSession_base(SessionSettings settings)
+{
+  try {
+    m_impl = Impl::create(settings);
+  }
+  CATCH_AND_WRAP
+}
+
+internal::XSession_base::XSession_base(SessionPool &pool)
+{
+  try {
+    if (!pool.m_impl)
+      throw_error("Session pool is closed");
+    m_impl = pool.m_impl->get();
   }
   CATCH_AND_WRAP
 }
@@ -399,9 +917,22 @@ void internal::XSession_base::close()
         node->session_closed();
       }
 
-      get_cdk_session().rollback();
+      m_impl->m_nodes.clear();
+
+      // Return pooled session to its pool which takes care of its state.
 
-      delete m_impl;
+      std::shared_ptr<SessionPool::Impl> pool;
+      pool.swap(m_impl->m_pool);
+
+      if (pool)
+      {
+        pool->release(m_impl);
+      }
+      else
+      {
+        get_cdk_session().rollback();
+        delete m_impl;
+      }
     }
     else if (m_impl)
     {
@@ -421,6 +952,54 @@ NodeSession XSession::bindToDefaultShard()
   return static_cast<XSession_base*>(this);
 }
 
+
+// ---------------------------------------------------------------------
+/*
+  Session pool.
+*/
+
+SessionPool::SessionPool(SessionSettings settings,
+                         unsigned max_size,
+                         unsigned min_size,
+                         unsigned long idle_timeout,
+                         unsigned long max_lifetime)
+{
+  try {
+
+    if (0 == max_size)
+      throw_error("Session pool size must be greater than 0");
+
+    if (min_size > max_size)
+      throw_error("Minimal session pool size larger than maximal one");
+
+    m_impl = std::make_shared<Impl>(settings, max_size, min_size,
+                                    idle_timeout, max_lifetime);
+    m_impl->open(min_size);
+    m_impl->start_reaper();
+  }
+  CATCH_AND_WRAP
+}
+
+
+SessionPool::~SessionPool()
+{
+  try {
+    close();
+  }
+  catch(...){}
+}
+
+
+void SessionPool::close()
+{
+  try {
+    if (m_impl)
+      m_impl->close();
+    m_impl.reset();
+  }
+  CATCH_AND_WRAP
+}
+
 // ---------------------------------------------------------------------
 
 
@@ -1200,8 +1779,18 @@ struct Op_sql : public Op_base<internal::SqlStatement_impl>
   }
   m_params;
 
+  /*
+    Note: If statement was already executed, binding a value starts a new
+    list of parameter values for the next execution.
+  */
+
   void add_param(Value val) override
   {
+    if (m_completed)
+    {
+      reset();
+      m_params.m_values.clear();
+    }
     m_params.m_values.emplace_back(std::move(val));
   }
 
@@ -77,6 +77,12 @@ class Op_table_insert
   Col_list m_cols;
   Col_list::iterator m_col_end = m_cols.before_begin();
 
+  // Rows sent in the current chunk are [m_chunk_begin, m_chunk_end).
+
+  Row_list::const_iterator m_chunk_begin;
+  Row_list::const_iterator m_chunk_end;
+  Chunk_limits m_chunk_limits;
+
 public:
 
   Op_table_insert(Table &tbl)
@@ -89,7 +95,13 @@ public:
     , m_table(other.m_table)
     , m_rows(other.m_rows)
     , m_cols(other.m_cols)
-  {}
+    , m_chunk_limits(other.m_chunk_limits)
+  {
+    // Iterators must point at the last elements of the copied lists.
+
+    m_row_end = last_pos(m_rows);
+    m_col_end = last_pos(m_cols);
+  }
 
   Executable_impl* clone() const override
   {
@@ -112,8 +124,22 @@ public:
     m_row_end = m_rows.emplace_after(m_row_end, row);
   }
 
+  void set_chunk_size(row_count_t rows, size_t bytes) override
+  {
+    m_chunk_limits.set(rows, bytes);
+  }
+
 private:
 
+  template <class L>
+  static typename L::iterator last_pos(L &list)
+  {
+    typename L::iterator pos = list.before_begin();
+    for (auto it = list.begin(); it != list.end(); ++it)
+      pos = it;
+    return pos;
+  }
+
   // Executable
 
   bool m_started;
@@ -126,9 +152,24 @@ private:
       return NULL;
 
     // Prepare iterators to make a pass through m_rows list.
-    m_started = false;
-    m_row_end = m_rows.end();
 
+    m_chunk_end = m_rows.cbegin();
+    next_chunk();
+
+    // If all rows fit into a single chunk, send them in one command.
+
+    if (m_chunk_end == m_rows.cend())
+      return send_chunk();
+
+    return send_chunks(
+      [this]() { return send_chunk(); },
+      [this]() { return next_chunk(); }
+    );
+  }
+
+
+  cdk::Reply* send_chunk()
+  {
     return new cdk::Reply(
       get_cdk_session().table_insert(m_table,
                                      *this,
@@ -138,17 +179,66 @@ private:
   }
 
 
+  /*
+    Move to the next chunk of rows, which starts after the current one
+    and contains as many rows as allowed by m_chunk_limits (but at least
+    one). Returns false if there are no more rows.
+  */
+
+  bool next_chunk()
+  {
+    m_started = false;
+    m_chunk_begin = m_chunk_end;
+
+    if (m_chunk_end == m_rows.cend())
+      return false;
+
+    row_count_t rows = 1;
+    size_t bytes = row_size(*m_chunk_end++);
+
+    while (m_chunk_end != m_rows.cend())
+    {
+      bytes += row_size(*m_chunk_end);
+      if (!m_chunk_limits.fits(++rows, bytes))
+        break;
+      ++m_chunk_end;
+    }
+
+    return true;
+  }
+
+  static size_t row_size(const Row &row)
+  {
+    size_t size = 0;
+    for (col_count_t pos = 0; pos < row.colCount(); ++pos)
+      size += Value::Access::size_estimate(row[pos]);
+    return size;
+  }
+
+
+  internal::BaseResult mk_result(cdk::Reply *reply) override
+  {
+    if (!reply)
+      return internal::BaseResult::Access::mk_empty();
+    if (m_chunks.empty())
+      return internal::BaseResult::Access::mk(m_sess, reply);
+    return internal::BaseResult::Access::mk(
+      m_sess, reply, std::vector<GUID>(), release_chunks()
+    );
+  }
+
+
   // Row_source (Iterator)
 
   bool next() override
   {
     if (!m_started)
-      m_cur_row = m_rows.cbegin();
+      m_cur_row = m_chunk_begin;
     else
       ++m_cur_row;
 
     m_started = true;
-    return m_cur_row != m_row_end;
+    return m_cur_row != m_chunk_end;
   }
 
 
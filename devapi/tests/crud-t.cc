@@ -1546,6 +1546,139 @@ TEST_F(Crud, count)
 }
 
 
+TEST_F(Crud, fetch_size)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Creating session..." << endl;
+
+  XSession sess(this);
+
+  cout << "Session accepted, creating collection..." << endl;
+
+  Schema sch = sess.getSchema("test");
+  Collection coll = sch.createCollection("coll", true);
+
+  coll.remove().execute();
+
+  {
+    CollectionAdd add(coll);
+
+    for (int i = 0; i < 100; ++i)
+    {
+      std::stringstream json;
+      json << "{ \"name\": \"foo\", \"age\":" << i << " }";
+
+      add.add(json.str());
+    }
+
+    add.execute();
+  }
+
+  Table tbl = sch.getCollectionAsTable("coll");
+
+  for (row_count_t size : { 1, 7, 50, 100, 200 })
+  {
+    cout << "fetch size: " << size << endl;
+
+    RowResult res = tbl.select("doc->$.age AS age")
+                       .orderBy("age").execute();
+    res.setFetchSize(size);
+
+    int i = 0;
+    for (Row row = res.fetchOne(); row; row = res.fetchOne(), ++i)
+      EXPECT_EQ(i, (int)row[0]);
+
+    EXPECT_EQ(100, i);
+  }
+
+  // Remaining prefetched rows are counted and returned.
+
+  {
+    RowResult res = tbl.select().execute();
+    res.setFetchSize(30);
+
+    EXPECT_TRUE(res.fetchOne());
+    EXPECT_EQ(99U, res.count());
+
+    std::vector<Row> rows = res.fetchAll();
+    EXPECT_EQ(99U, rows.size());
+  }
+}
+
+
+TEST_F(Crud, fetch_many)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Creating session..." << endl;
+
+  XSession sess(this);
+
+  cout << "Session accepted, creating collection..." << endl;
+
+  Schema sch = sess.getSchema("test");
+  Collection coll = sch.createCollection("coll", true);
+
+  coll.remove().execute();
+
+  {
+    CollectionAdd add(coll);
+
+    for (int i = 0; i < 100; ++i)
+    {
+      std::stringstream json;
+      json << "{ \"name\": \"foo\", \"age\":" << i << " }";
+
+      add.add(json.str());
+    }
+
+    add.execute();
+  }
+
+  {
+    Table tbl = sch.getCollectionAsTable("coll");
+    RowResult res = tbl.select("doc->$.age AS age")
+                       .orderBy("age").execute();
+
+    RowList rows = res.fetchMany(30);
+    EXPECT_EQ(30U, rows.size());
+
+    int i = 0;
+    for (Row row : rows)
+      EXPECT_EQ(i++, (int)row[0]);
+
+    EXPECT_THROW(rows[30], out_of_range);
+
+    // Rows remain valid after the list is gone.
+
+    Row row = res.fetchMany(1)[0];
+    EXPECT_EQ(30, (int)row[0]);
+
+    rows = res.fetchAll();
+    EXPECT_EQ(69U, rows.size());
+    EXPECT_EQ(31, (int)rows[0][0]);
+
+    EXPECT_EQ(0U, res.fetchMany(10).size());
+  }
+
+  {
+    DocResult res = coll.find().sort("age").execute();
+
+    DocList docs = res.fetchMany(60);
+    EXPECT_EQ(60U, docs.size());
+
+    int i = 0;
+    for (DbDoc doc : docs)
+      EXPECT_EQ(i++, (int)doc["age"]);
+
+    std::vector<DbDoc> rest = res.fetchAll();
+    EXPECT_EQ(40U, rest.size());
+    EXPECT_EQ(60, (int)rest[0]["age"]);
+  }
+}
+
+
 TEST_F(Crud, buffered)
 {
   SKIP_IF_NO_XPLUGIN;
@@ -1863,6 +1996,30 @@ TEST_F(Crud, doc_id)
 
   EXPECT_THROW(coll.add("{\"_id\": 127 }").execute(), Error);
   EXPECT_THROW(coll.add("{\"_id\": 12.7 }").execute(), Error);
+
+  coll.remove().execute();
+
+  // Only top-level _id key is the document id.
+
+  Result res = coll.add("{ \"a\": { \"_id\": \"nested\" }, \"b\": [\"_id\"] }")
+                   .add("{}")
+                   .add("{ \"a\": \"}\","
+                        " \"_id\" : \"0123456789ABCDEF0123456789ABCDEF\" }")
+                   .execute();
+
+  std::vector<mysqlx::GUID> ids = res.getDocumentIds();
+
+  EXPECT_EQ(3, ids.size());
+  EXPECT_NE(string("nested"), string(ids[0]));
+  EXPECT_EQ(string("0123456789ABCDEF0123456789ABCDEF"), string(ids[2]));
+
+  for (unsigned i = 0; i < ids.size(); ++i)
+  {
+    DbDoc doc = coll.find("_id = :id").bind("id", string(ids[i]))
+                    .execute().fetchOne();
+    EXPECT_TRUE((bool)doc);
+    cout << "doc#" << i << ": " << doc << endl;
+  }
 }
 
 TEST_F(Crud, group_by_having)
@@ -2054,3 +2211,208 @@ TEST_F(Crud, copy_semantics)
 
   cout << "Done!" << endl;
 }
+
+
+TEST_F(Crud, prepared)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Creating session..." << endl;
+
+  XSession sess(this);
+
+  cout << "Session accepted, creating collection..." << endl;
+
+  Schema sch = sess.getSchema("test");
+  Collection coll = sch.createCollection("c1", true);
+
+  add_data(coll);
+
+  cout << "Executing the same find operation many times..." << endl;
+
+  CollectionFind find = coll.find("age < :age");
+  find.sort("age DESC");
+  find.fields("name AS name", "age AS age");
+
+  struct
+  {
+    int age;
+    unsigned count;
+    int first;
+  }
+  data[] = {
+    { 3, 3, 2 },
+    { 10, 5, 7 },
+    { 2, 2, 1 },
+    { 100, 6, 17 },
+  };
+
+  for (auto &el : data)
+  {
+    find.bind("age", el.age);
+    DocResult docs = find.execute();
+
+    DbDoc doc = docs.fetchOne();
+    EXPECT_EQ(el.first, (int)doc["age"]);
+
+    unsigned i = 1;
+    for (; docs.fetchOne(); ++i);
+
+    EXPECT_EQ(el.count, i);
+  }
+
+  cout << "Executing copy of the operation..." << endl;
+
+  CollectionFind find2 = find;
+  find2.bind("age", 3);
+  EXPECT_EQ(2, (int)find2.execute().fetchOne()["age"]);
+
+  cout << "Executing SQL statement many times..." << endl;
+
+  SqlStatement &stmt = get_sess().sql("SELECT ? + ?");
+
+  EXPECT_EQ(3, (int)stmt.bind(1, 2).execute().fetchOne()[0]);
+  EXPECT_EQ(7, (int)stmt.bind(3, 4).execute().fetchOne()[0]);
+
+  cout << "Re-executing table insert after adding rows..." << endl;
+
+  sql("DROP TABLE IF EXISTS test.crud_prepared");
+  sql("CREATE TABLE test.crud_prepared(id INT AUTO_INCREMENT PRIMARY KEY, i INT)");
+
+  Table tbl = sch.getTable("crud_prepared");
+  TableInsert insert = tbl.insert("i");
+
+  insert.values(1);
+  insert.execute();
+
+  // Rows are added after the ones already present, also in a copy.
+
+  insert.values(2);
+  insert.execute();
+
+  TableInsert insert2 = insert;
+  insert2.values(3);
+  insert2.execute();
+
+  RowResult rows = tbl.select("i").orderBy("id").execute();
+  std::vector<int> vals;
+  for (Row row = rows.fetchOne(); row; row = rows.fetchOne())
+    vals.push_back((int)row[0]);
+
+  std::vector<int> expected = { 1, 1, 2, 1, 2, 3 };
+  EXPECT_EQ(expected, vals);
+
+  cout << "Done!" << endl;
+}
+
+
+TEST_F(Crud, chunks)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Creating session..." << endl;
+
+  XSession sess(this);
+
+  cout << "Session accepted, creating collection..." << endl;
+
+  Schema sch = sess.getSchema("test");
+  Collection coll = sch.createCollection("c1", true);
+
+  coll.remove().execute();
+
+  cout << "Adding documents in chunks..." << endl;
+
+  CollectionAdd add(coll);
+
+  for (int i = 0; i < 100; ++i)
+  {
+    std::ostringstream buf;
+    buf << "{ \"i\": " << i << " }";
+    add.add(buf.str());
+  }
+
+  // 15 chunks of at most 7 documents
+
+  Result res = add.chunkSize(7, 0).execute();
+
+  EXPECT_EQ(100U, res.getAffectedItemsCount());
+
+  std::vector<mysqlx::GUID> ids = res.getDocumentIds();
+  EXPECT_EQ(100U, ids.size());
+  EXPECT_EQ(100U, coll.count());
+
+  // Chunks limited by size
+
+  coll.remove().execute();
+  res = add.chunkSize(0, 64).execute();
+  EXPECT_EQ(100U, res.getAffectedItemsCount());
+  EXPECT_EQ(100U, coll.count());
+
+  cout << "Inserting rows in chunks..." << endl;
+
+  sql("DROP TABLE IF EXISTS test.crud_chunks");
+  sql("CREATE TABLE test.crud_chunks(id INT AUTO_INCREMENT PRIMARY KEY, i INT)");
+
+  Table tbl = sch.getTable("crud_chunks");
+  TableInsert insert = tbl.insert("i");
+
+  for (int i = 0; i < 100; ++i)
+    insert.values(i);
+
+  res = insert.chunkSize(9, 0).execute();
+
+  EXPECT_EQ(100U, res.getAffectedItemsCount());
+  EXPECT_EQ(1U, res.getAutoIncrementValue());
+  EXPECT_EQ(100U, tbl.count());
+
+  cout << "Failing chunk..." << endl;
+
+  /*
+    Third chunk fails because of duplicate id. Chunks before it are
+    processed and the operation reports the error.
+  */
+
+  coll.remove().execute();
+
+  {
+    CollectionAdd add_dup(coll);
+
+    add_dup.add("{ \"_id\": \"A\", \"i\": 1 }")
+           .add("{ \"_id\": \"B\", \"i\": 2 }")
+           .add("{ \"_id\": \"A\", \"i\": 3 }")
+           .add("{ \"_id\": \"C\", \"i\": 4 }");
+
+    EXPECT_THROW(add_dup.chunkSize(1, 0).execute(), mysqlx::Error);
+  }
+
+  EXPECT_EQ(1U, coll.find("_id = 'A'").execute().count());
+  EXPECT_EQ(1U, coll.find("_id = 'B'").execute().count());
+  EXPECT_EQ(0U, coll.find("i = 3").execute().count());
+
+  // The last chunk was in flight when the error was detected.
+
+  EXPECT_EQ(1U, coll.find("_id = 'C'").execute().count());
+
+  // Session remains usable.
+
+  EXPECT_EQ(3U, coll.count());
+
+  // Without chunk limits the operation is a single, atomic command.
+
+  coll.remove().execute();
+
+  {
+    CollectionAdd add_dup(coll);
+
+    add_dup.add("{ \"_id\": \"A\", \"i\": 1 }")
+           .add("{ \"_id\": \"B\", \"i\": 2 }")
+           .add("{ \"_id\": \"A\", \"i\": 3 }");
+
+    EXPECT_THROW(add_dup.execute(), mysqlx::Error);
+  }
+
+  EXPECT_EQ(0U, coll.count());
+
+  cout << "Done!" << endl;
+}
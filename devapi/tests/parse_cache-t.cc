@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This code is licensed under the terms of the GPLv2
+ * <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+ * MySQL Connectors. There are special exceptions to the terms and
+ * conditions of the GPLv2 as it is applied to this software, see the
+ * FLOSS License Exception
+ * <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+
+/*
+  Unit tests for the cache of parsed CRUD specification strings
+  (Parse_cache in impl.h). They do not need a server.
+*/
+
+#include "../impl.h"
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <stdexcept>
+
+using std::cout;
+using std::endl;
+using parser::Parser_mode;
+
+
+/*
+  Stand-in for a parse result. Each instance records the value of
+  the parse counter at the time it was created.
+*/
+
+struct Test_stored
+{
+  unsigned m_id = 0;
+};
+
+typedef mysqlx::Parse_cache<Test_stored> Test_cache;
+
+
+struct Test_parse
+{
+  std::atomic<unsigned> &m_count;
+
+  Test_parse(std::atomic<unsigned> &count) : m_count(count)
+  {}
+
+  void operator()(Test_stored &stored) const
+  {
+    stored.m_id = ++m_count;
+  }
+};
+
+
+TEST(Parse_cache, hit)
+{
+  Test_cache cache;
+  std::atomic<unsigned> count(0);
+
+  Test_cache::Ptr p1 = cache.get(Parser_mode::DOCUMENT, L"a > 1", Test_parse(count));
+  Test_cache::Ptr p2 = cache.get(Parser_mode::DOCUMENT, L"a > 1", Test_parse(count));
+
+  EXPECT_EQ(1U, count);
+  EXPECT_EQ(p1, p2);
+  EXPECT_EQ(1U, p2->m_id);
+
+  Test_cache::Ptr p3 = cache.get(Parser_mode::DOCUMENT, L"a > 2", Test_parse(count));
+
+  EXPECT_EQ(2U, count);
+  EXPECT_NE(p1, p3);
+}
+
+
+TEST(Parse_cache, mode)
+{
+  Test_cache cache;
+  std::atomic<unsigned> count(0);
+
+  // The same string is parsed differently in each mode.
+
+  Test_cache::Ptr doc = cache.get(Parser_mode::DOCUMENT, L"a", Test_parse(count));
+  Test_cache::Ptr tbl = cache.get(Parser_mode::TABLE, L"a", Test_parse(count));
+
+  EXPECT_EQ(2U, count);
+  EXPECT_NE(doc, tbl);
+
+  EXPECT_EQ(doc, cache.get(Parser_mode::DOCUMENT, L"a", Test_parse(count)));
+  EXPECT_EQ(tbl, cache.get(Parser_mode::TABLE, L"a", Test_parse(count)));
+  EXPECT_EQ(2U, count);
+}
+
+
+TEST(Parse_cache, eviction)
+{
+  Test_cache cache;
+  std::atomic<unsigned> count(0);
+  std::vector<std::wstring> keys;
+  const size_t capacity = Test_cache::capacity;
+
+  for (size_t i = 0; i <= capacity; ++i)
+    keys.push_back(L"a = " + std::to_wstring(i));
+
+  Test_cache::Ptr first
+    = cache.get(Parser_mode::DOCUMENT, keys[0], Test_parse(count));
+
+  for (size_t i = 1; i < capacity; ++i)
+    cache.get(Parser_mode::DOCUMENT, keys[i], Test_parse(count));
+
+  EXPECT_EQ(capacity, count);
+
+  // Cache is full. Use the first entry so that the second one becomes
+  // the least recently used.
+
+  EXPECT_EQ(first, cache.get(Parser_mode::DOCUMENT, keys[0], Test_parse(count)));
+
+  Test_cache::Ptr second
+    = cache.get(Parser_mode::DOCUMENT, keys[1], Test_parse(count));
+  EXPECT_EQ(capacity, count);
+
+  // Adding one more entry removes the least recently used one, which is
+  // now the third one.
+
+  cache.get(Parser_mode::DOCUMENT, keys[capacity],
+            Test_parse(count));
+  EXPECT_EQ(capacity + 1, count);
+
+  EXPECT_EQ(first, cache.get(Parser_mode::DOCUMENT, keys[0], Test_parse(count)));
+  EXPECT_EQ(second, cache.get(Parser_mode::DOCUMENT, keys[1], Test_parse(count)));
+  EXPECT_EQ(capacity + 1, count);
+
+  Test_cache::Ptr third
+    = cache.get(Parser_mode::DOCUMENT, keys[2], Test_parse(count));
+  EXPECT_EQ(capacity + 2, count);
+  EXPECT_EQ(capacity + 2, third->m_id);
+
+  // Evicted parse result is still valid for its users.
+
+  EXPECT_EQ(1U, first->m_id);
+}
+
+
+TEST(Parse_cache, error)
+{
+  Test_cache cache;
+  std::atomic<unsigned> count(0);
+
+  auto fail = [&count](Test_stored&)
+  {
+    ++count;
+    throw std::runtime_error("parse error");
+  };
+
+  EXPECT_THROW(cache.get(Parser_mode::DOCUMENT, L"a >", fail),
+               std::runtime_error);
+
+  // Failed parse is not cached -- the error is reported again.
+
+  EXPECT_THROW(cache.get(Parser_mode::DOCUMENT, L"a >", fail),
+               std::runtime_error);
+  EXPECT_EQ(2U, count);
+
+  Test_cache::Ptr p = cache.get(Parser_mode::DOCUMENT, L"a >", Test_parse(count));
+  EXPECT_EQ(3U, p->m_id);
+}
+
+
+/*
+  Threads which ask for the same string at the same time all get the same
+  parse result, even if more than one of them parsed it.
+*/
+
+TEST(Parse_cache, threads)
+{
+  Test_cache cache;
+  std::atomic<unsigned> count(0);
+
+  const unsigned thread_count = 8;
+  std::vector<Test_cache::Ptr> results(thread_count);
+  std::vector<std::thread> threads;
+
+  auto slow_parse = [&count](Test_stored &stored)
+  {
+    stored.m_id = ++count;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  };
+
+  for (unsigned t = 0; t < thread_count; ++t)
+    threads.emplace_back([&, t]()
+    {
+      results[t] = cache.get(Parser_mode::TABLE, L"b < 10", slow_parse);
+    });
+
+  for (std::thread &thd : threads)
+    thd.join();
+
+  EXPECT_LE(1U, count);
+  EXPECT_GE(thread_count, count);
+
+  for (unsigned t = 0; t < thread_count; ++t)
+    EXPECT_EQ(results[0], results[t]);
+
+  EXPECT_EQ(results[0], cache.get(Parser_mode::TABLE, L"b < 10", slow_parse));
+}
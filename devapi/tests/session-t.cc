@@ -24,6 +24,8 @@
 
 #include <test.h>
 #include <iostream>
+#include <thread>
+#include <chrono>
 #include <boost/format.hpp>
 
 using std::cout;
@@ -581,3 +583,178 @@ TEST_F(Sess, ipv6)
     EXPECT_FALSE(cipher.empty());
   }
 }
+
+
+TEST_F(Sess, unix_socket)
+{
+
+  SKIP_IF_NO_XPLUGIN;
+
+#ifdef _WIN32
+  cout << "Unix domain sockets not supported on this platform" << endl;
+  return;
+#else
+
+  string socket;
+
+  {
+    mysqlx::XSession sess(SessionSettings::PORT, get_port(),
+                          SessionSettings::USER, get_user(),
+                          SessionSettings::PWD, get_password() ? get_password() : nullptr);
+
+    SqlResult res = sess.bindToDefaultShard()
+                    .sql("show global variables like 'mysqlx_socket'")
+                    .execute();
+
+    Row row = res.fetchOne();
+    if (!row || row[1].isNull())
+    {
+      cout << "X Plugin socket not available" << endl;
+      return;
+    }
+
+    socket = row.get(1);
+  }
+
+  cout << "socket: " << socket << endl;
+
+  {
+    mysqlx::XSession sess(SessionSettings::SOCKET, socket,
+                          SessionSettings::USER, get_user(),
+                          SessionSettings::PWD, get_password() ? get_password() : nullptr);
+
+    SqlResult res = sess.bindToDefaultShard().sql("SELECT 1").execute();
+    EXPECT_EQ(1, (int)res.fetchOne()[0]);
+  }
+
+  //Using URI
+
+  std::stringstream uri;
+
+  uri << "mysqlx://" << get_user();
+
+  if (get_password() && *get_password())
+    uri << ":"<< get_password();
+
+  uri << "@" << "localhost/?socket=" << socket;
+
+  {
+    mysqlx::XSession sess(uri.str());
+
+    SqlResult res = sess.bindToDefaultShard().sql("SELECT 1").execute();
+    EXPECT_EQ(1, (int)res.fetchOne()[0]);
+  }
+
+  EXPECT_THROW(
+    mysqlx::XSession sess(SessionSettings::SOCKET, "/no/such/socket",
+                          SessionSettings::USER, get_user(),
+                          SessionSettings::PWD, get_password() ? get_password() : nullptr)
+    , mysqlx::Error);
+
+#endif
+}
+
+
+TEST_F(Sess, pool)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  SessionPool pool(SessionSettings(m_port, m_user, m_password, "test"), 2);
+
+  uint64_t conn_id;
+
+  {
+    mysqlx::NodeSession s(pool);
+
+    conn_id = s.sql("SELECT CONNECTION_ID()").execute().fetchOne()[0];
+    s.sql("SET @pool_var = 1").execute();
+    s.sql("USE mysql").execute();
+  }
+
+  // Connection is re-used, but session state is reset.
+
+  {
+    mysqlx::NodeSession s(pool);
+
+    uint64_t id = s.sql("SELECT CONNECTION_ID()").execute().fetchOne()[0];
+    EXPECT_EQ(conn_id, id);
+
+    Row row = s.sql("SELECT @pool_var, DATABASE()").execute().fetchOne();
+    EXPECT_TRUE(row[0].isNull());
+    EXPECT_EQ(string("test"), (string)row[1]);
+    EXPECT_EQ(string("test"), s.getDefaultSchemaName());
+
+    // Second session gets a new connection.
+
+    mysqlx::NodeSession s1(pool);
+
+    id = s1.sql("SELECT CONNECTION_ID()").execute().fetchOne()[0];
+    EXPECT_NE(conn_id, id);
+  }
+
+  pool.close();
+  EXPECT_THROW(mysqlx::NodeSession s(pool), Error);
+
+  cout << "Done!" << endl;
+}
+
+
+/*
+  Idle connection which was closed by the server is not handed out
+  by the pool.
+*/
+
+TEST_F(Sess, pool_dead_connection)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  SessionPool pool(SessionSettings(m_port, m_user, m_password), 1, 1);
+
+  uint64_t conn_id;
+
+  {
+    mysqlx::NodeSession s(pool);
+    conn_id = s.sql("SELECT CONNECTION_ID()").execute().fetchOne()[0];
+  }
+
+  get_sess().sql("KILL ?").bind(conn_id).execute();
+
+  mysqlx::NodeSession s(pool);
+
+  uint64_t id = s.sql("SELECT CONNECTION_ID()").execute().fetchOne()[0];
+  EXPECT_NE(conn_id, id);
+
+  cout << "Done!" << endl;
+}
+
+
+/*
+  Expired idle connections are closed and replaced so that the pool
+  keeps min_size connections open.
+*/
+
+TEST_F(Sess, pool_reaper)
+{
+  SKIP_IF_NO_XPLUGIN;
+
+  SessionPool pool(SessionSettings(m_port, m_user, m_password), 2, 1, 0, 100);
+
+  uint64_t conn_id;
+
+  {
+    mysqlx::NodeSession s(pool);
+    conn_id = s.sql("SELECT CONNECTION_ID()").execute().fetchOne()[0];
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  // Expired connection was replaced with a new one.
+
+  {
+    mysqlx::NodeSession s(pool);
+    uint64_t id = s.sql("SELECT CONNECTION_ID()").execute().fetchOne()[0];
+    EXPECT_NE(conn_id, id);
+  }
+
+  cout << "Done!" << endl;
+}
@@ -27,6 +27,7 @@
 #include <array>
 #include <cmath>  // for fabs()
 #include <vector>
+#include <sstream>
 
 using std::cout;
 using std::wcout;
@@ -201,6 +202,41 @@ TEST_F(Types, numeric)
 }
 
 
+TEST_F(Types, row)
+{
+  // Values stored in a row do not move when the row is extended.
+
+  Row row;
+
+  Value &first = row.set(0, 7);
+  Value &second = row.set(1, "foo");
+
+  for (col_count_t pos = 2; pos < 1000; ++pos)
+    row.set(pos, pos);
+
+  EXPECT_EQ(1000, row.colCount());
+  EXPECT_EQ(&first, &row[0]);
+  EXPECT_EQ(&second, &row[1]);
+  EXPECT_EQ(7, (int)first);
+  EXPECT_EQ(string("foo"), (string)second);
+  EXPECT_EQ(999U, (unsigned)row[999]);
+
+  first = 8;
+  EXPECT_EQ(8, (int)row[0]);
+
+  // Skipped positions hold no value until they are accessed.
+
+  Row row1;
+  Value &last = row1.set(3, 1);
+  const Row &crow1 = row1;
+
+  EXPECT_EQ(4, row1.colCount());
+  EXPECT_THROW(crow1[1], out_of_range);
+  EXPECT_TRUE(row1[1].isNull());
+  EXPECT_EQ(&last, &row1[3]);
+}
+
+
 TEST_F(Types, basic)
 {
   SKIP_IF_NO_XPLUGIN;
@@ -317,8 +353,19 @@ TEST_F(Types, basic)
   row = res.fetchOne();
 
   EXPECT_TRUE(row);
+  EXPECT_TRUE(row.isNull(1));
   EXPECT_TRUE(row[0].isNull());
   EXPECT_TRUE(row[1].isNull());
+  EXPECT_TRUE(row.isNull(0));
+  EXPECT_TRUE(row.isNull(7));
+
+  types.update().set("c0", 7).execute();
+  res = types.select("c0","c1").execute();
+  row = res.fetchOne();
+
+  EXPECT_FALSE(row.isNull(0));
+  EXPECT_TRUE(row.isNull(1));
+  EXPECT_EQ(7, (int)row[0]);
 
   cout << "Done!" << endl;
 }
@@ -452,6 +499,11 @@ TEST_F(Types, string)
   EXPECT_EQ(str0, (string)row[0]);
   EXPECT_EQ(str1, (string)row[1]);
 
+  // UTF-8 access to string values.
+
+  EXPECT_EQ(std::string("Foobar"), row[0].getUtf8());
+  EXPECT_EQ((std::string)str1, row[1].getUtf8());
+
   /*
     FIXME: the third colum contains non-utf8 string which uses non-ascii
     characters. Currently we do not handle such strings and an error is
@@ -622,8 +674,162 @@ TEST_F(Types, json)
 }
 
 
+/*
+  Document fields are decoded on demand - check that values obtained
+  this way are the same as when whole document is processed.
+*/
+
+TEST_F(Types, doc_fields)
+{
+  const char *json = "{"
+    "\"foo\": 7,"
+    "\"str\": \"a \\\"quoted\\\" string, with {braces}\","
+    "\"arr\": [1, 2, \"string\", {\"x\": []}],"
+    "\"sub\": { \"day\": 20, \"month\": \"Apr\", \"sub\": {\"y\": true} },"
+    "\"foo\": 8,"
+    "\"none\": null"
+  "}";
+
+  DbDoc doc(json);
+
+  EXPECT_TRUE(doc.hasField("sub"));
+  EXPECT_FALSE(doc.hasField("bar"));
+  EXPECT_THROW(doc["bar"], Error);
+
+  EXPECT_EQ(Value::DOCUMENT, doc["sub"].getType());
+  EXPECT_EQ(20, (int)doc["sub"]["day"]);
+  EXPECT_TRUE((bool)doc["sub"]["sub"]["y"]);
+  EXPECT_EQ(string("a \"quoted\" string, with {braces}"), (string)doc["str"]);
+  EXPECT_EQ(std::string("a \"quoted\" string, with {braces}"),
+            doc["str"].getUtf8());
+  EXPECT_THROW(doc["foo"].getUtf8(), Error);
+
+  // Reference to a decoded value remains valid after decoding others.
+
+  const Value &foo = doc["foo"];
+  EXPECT_EQ(7, (int)foo);
+
+  unsigned cnt = 0;
+  for (Field fld : doc)
+  {
+    cout << "field " << fld << ": " << doc[fld] << endl;
+    cnt++;
+  }
+
+  EXPECT_EQ(5U, cnt);
+  EXPECT_EQ(7, (int)foo);
+  EXPECT_EQ(Value::VNULL, doc["none"].getType());
+  EXPECT_EQ(4U, doc["arr"].elementCount());
+  EXPECT_EQ(Value::DOCUMENT, doc["arr"][3].getType());
+  EXPECT_EQ(string("Apr"), (string)doc["sub"]["month"]);
+
+  EXPECT_THROW(DbDoc("{ \"foo\": 7,").hasField("foo"), Error);
+}
+
+
+TEST_F(Types, decimal)
+{
+  {
+    Decimal dec;
+    dec.value = -314;
+    dec.scale = 2;
+
+    EXPECT_DOUBLE_EQ(-3.14, (double)dec);
+
+    std::ostringstream buf;
+    buf << dec;
+    EXPECT_EQ("-3.14", buf.str());
+
+    dec.value = 5;
+    dec.scale = 3;
+    buf.str("");
+    buf << dec;
+    EXPECT_EQ("0.005", buf.str());
+
+    dec.value = 7;
+    dec.scale = 0;
+    buf.str("");
+    buf << dec;
+    EXPECT_EQ("7", buf.str());
+  }
+
+  SKIP_IF_NO_XPLUGIN;
+
+  cout << "Preparing test.types..." << endl;
+
+  sql("DROP TABLE IF EXISTS test.types");
+  sql(
+    "CREATE TABLE test.types("
+    "  c0 DECIMAL(10,3),"
+    "  c1 DECIMAL(20,0),"
+    "  c2 DOUBLE"
+    ")");
+
+  Table types = getSchema("test").getTable("types");
+
+  types.insert()
+    .values("3.14", "-12345678901234567890", 3.14)
+    .values(nullvalue, 0, 0)
+    .execute();
+
+  RowResult res = types.select().execute();
+
+  Row row = res.fetchOne();
+  EXPECT_TRUE(row);
+
+  Decimal c0 = row.getDecimal(0);
+  cout << "c0: " << c0 << endl;
+  EXPECT_EQ(3140, c0.value);
+  EXPECT_EQ(3U, c0.scale);
+  EXPECT_DOUBLE_EQ(3.14, (double)c0);
+
+  // Value of c1 does not fit in 64-bit integer.
+
+  EXPECT_THROW(row.getDecimal(1), Error);
+
+  // DOUBLE field can not be read as Decimal.
+
+  EXPECT_THROW(row.getDecimal(2), Error);
+  EXPECT_THROW(row.getDecimal(3), out_of_range);
+
+  row = res.fetchOne();
+  EXPECT_TRUE(row);
+
+  EXPECT_THROW(row.getDecimal(0), Error);
+
+  Decimal c1 = row.getDecimal(1);
+  EXPECT_EQ(0, c1.value);
+  EXPECT_EQ(0U, c1.scale);
+
+  cout << "Done!" << endl;
+}
+
+
 TEST_F(Types, datetime)
 {
+  {
+    Datetime dt;
+    dt.year = 2014;
+    dt.month = 5;
+    dt.day = 1;
+    dt.hour = 9;
+
+    std::ostringstream buf;
+    buf << dt;
+    EXPECT_EQ("2014-05-01 09:00:00", buf.str());
+
+    Time t;
+    t.negative = true;
+    t.hours = 838;
+    t.minutes = 59;
+    t.seconds = 59;
+    t.usec = 1;
+
+    buf.str("");
+    buf << t;
+    EXPECT_EQ("-838:59:59.000001", buf.str());
+  }
+
   SKIP_IF_NO_XPLUGIN;
 
   cout << "Preparing test.types..." << endl;
@@ -681,6 +887,37 @@ TEST_F(Types, datetime)
     cout << "- col#" << j << ": " << row[j] << endl;
     EXPECT_EQ(Value::RAW, row[j].getType());
   }
+
+  cout << "Decoding values..." << endl;
+
+  Datetime d0 = row.getDatetime(0);
+  cout << "- col#0: " << d0 << endl;
+  EXPECT_EQ(2014U, d0.year);
+  EXPECT_EQ(5U, d0.month);
+  EXPECT_EQ(11U, d0.day);
+  EXPECT_EQ(0U, d0.hour);
+
+  Time t1 = row.getTime(1);
+  cout << "- col#1: " << t1 << endl;
+  EXPECT_FALSE(t1.negative);
+  EXPECT_EQ(10U, t1.hours);
+  EXPECT_EQ(40U, t1.minutes);
+  EXPECT_EQ(23U, t1.seconds);
+
+  Datetime d2 = row.getDatetime(2);
+  cout << "- col#2: " << d2 << endl;
+  EXPECT_EQ(2014U, d2.year);
+  EXPECT_EQ(10U, d2.hour);
+  EXPECT_EQ(40U, d2.minute);
+  EXPECT_EQ(0U, d2.second);
+
+  Datetime d3 = row.getDatetime(3);
+  cout << "- col#3: " << d3 << endl;
+  EXPECT_EQ(11U, d3.hour);
+  EXPECT_EQ(35U, d3.minute);
+
+  EXPECT_THROW(row.getTime(0), Error);
+  EXPECT_THROW(row.getDatetime(1), Error);
 }
 
 
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This code is licensed under the terms of the GPLv2
+ * <http://www.gnu.org/licenses/old-licenses/gpl-2.0.html>, like most
+ * MySQL Connectors. There are special exceptions to the terms and
+ * conditions of the GPLv2 as it is applied to this software, see the
+ * FLOSS License Exception
+ * <http://www.mysql.com/about/legal/licensing/foss-exception.html>.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+
+/*
+  Tests for the UUID generator used to generate document ids.
+*/
+
+#include <uuid_gen.h>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <string>
+#include <set>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <cstring>
+
+using std::cout;
+using std::endl;
+
+
+static std::string uuid_str(const uuid::uuid_type &id)
+{
+  char buf[2 * UUID_LENGTH_BIN];
+  uuid::to_hex(id, buf);
+  return std::string(buf, sizeof(buf));
+}
+
+
+TEST(UUID, to_hex)
+{
+  uuid::uuid_type id;
+
+  for (unsigned i = 0; i < UUID_LENGTH_BIN; ++i)
+    id[i] = (unsigned char)(0x10 * i + 0x0F - i);
+
+  EXPECT_EQ(std::string("0F1E2D3C4B5A69788796A5B4C3D2E1F0"), uuid_str(id));
+
+  memset(id, 0, sizeof(id));
+  EXPECT_EQ(std::string(32, '0'), uuid_str(id));
+
+  memset(id, 0xFF, sizeof(id));
+  EXPECT_EQ(std::string(32, 'F'), uuid_str(id));
+}
+
+
+TEST(UUID, generate_uuids)
+{
+  uuid::set_seed_from_time_pid();
+
+  const size_t count = 10000;
+  std::unique_ptr<uuid::uuid_type[]> ids(new uuid::uuid_type[count]);
+  std::set<std::string> seen;
+
+  uuid::generate_uuids(ids.get(), count);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    // Version field (stored in byte 9 of the generated UUID) is 1.
+    EXPECT_EQ(0x10, ids[i][9] & 0xF0);
+    EXPECT_TRUE(seen.insert(uuid_str(ids[i])).second);
+  }
+
+  // UUIDs generated one by one continue the same sequence.
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    uuid::uuid_type id;
+    uuid::generate_uuid(id);
+    EXPECT_TRUE(seen.insert(uuid_str(id)).second);
+  }
+
+  // Nothing is generated for empty request.
+
+  uuid::uuid_type id;
+  memset(id, 0, sizeof(id));
+  uuid::generate_uuids(&id, 0);
+  EXPECT_EQ(std::string(32, '0'), uuid_str(id));
+}
+
+
+/*
+  Generate UUIDs from many threads at the same time. Threads are
+  started in several rounds, so that later threads re-use indexes of
+  threads that exited before.
+*/
+
+TEST(UUID, threads)
+{
+  uuid::set_seed_from_time_pid();
+
+  const unsigned rounds = 4;
+  const unsigned thread_count = 16;
+  const size_t id_count = 5000;
+
+  std::mutex lock;
+  std::set<std::string> seen;
+  size_t duplicates = 0;
+
+  for (unsigned r = 0; r < rounds; ++r)
+  {
+    std::vector<std::thread> threads;
+
+    for (unsigned t = 0; t < thread_count; ++t)
+      threads.emplace_back([&, t]()
+      {
+        std::unique_ptr<uuid::uuid_type[]> ids(new uuid::uuid_type[id_count]);
+
+        // Half of the threads borrow time values from the future.
+
+        if (t % 2)
+          uuid::generate_uuids(ids.get(), id_count);
+        else
+          for (size_t i = 0; i < id_count; ++i)
+            uuid::generate_uuid(ids[i]);
+
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t i = 0; i < id_count; ++i)
+          if (!seen.insert(uuid_str(ids[i])).second)
+            duplicates++;
+      });
+
+    for (std::thread &thd : threads)
+      thd.join();
+  }
+
+  EXPECT_EQ(0U, duplicates);
+  EXPECT_EQ(rounds * thread_count * id_count, seen.size());
+}
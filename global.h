@@ -31,13 +31,13 @@
 namespace mysqlx {
 
 /*
-  Wrapper around uuid generator which ensures that it is properly
+  Wrappers around uuid generator which ensure that it is properly
   initialized using process id (so that concurrent processes use
   different UUIDs).
 */
 
 inline
-void generate_uuid(uuid::uuid_type &buf)
+void init_uuid()
 {
   /*
     Note: This static initializer instance will be constructed
@@ -51,10 +51,22 @@ void generate_uuid(uuid::uuid_type &buf)
     }
   }
   uuid_init;
+}
 
+inline
+void generate_uuid(uuid::uuid_type &buf)
+{
+  init_uuid();
   uuid::generate_uuid(buf);
 }
 
+inline
+void generate_uuids(uuid::uuid_type *buf, size_t count)
+{
+  init_uuid();
+  uuid::generate_uuids(buf, count);
+}
+
 }
 
 #endif
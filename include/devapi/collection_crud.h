@@ -332,6 +332,13 @@ namespace internal {
     */
 
     virtual void add_json(const string&) = 0;
+
+    /*
+      Set limits for the number of documents and the number of bytes
+      sent in a single chunk of the operation (0 means no limit).
+    */
+
+    virtual void set_chunk_size(row_count_t, size_t) = 0;
   };
 
   /// TODO
@@ -357,6 +364,11 @@ namespace internal {
   @note Generated document identifiers are based on UUIDs but they are not
   valid UUIDs (fields are reversed).
 
+  All documents are added with a single insert command, unless limits for
+  a single chunk are set with `chunkSize()` method. Then documents are sent
+  to the server in several chunks, each one being a separate insert command.
+  Commands are pipelined and their results are combined into a single Result.
+
   @cond IGNORE
   The various `add()` methods defined by `CollectionAddInterface`
   call `do_add()` to append documents to the list one by one. This
@@ -387,6 +399,25 @@ public:
   CollectionAdd(CollectionAdd &other) : Executable(other) {}
   CollectionAdd(CollectionAdd &&other) : Executable(std::move(other)) {}
 
+  /**
+    Limit the number of documents and the number of bytes of document data
+    sent to the server in a single chunk (0 means no limit). By default
+    there are no limits and all documents are added by a single command.
+
+    @note If a chunk fails, documents from chunks sent before it are added
+    to the collection, and so can be documents from up to 3 chunks which
+    were sent after it. Use a transaction if the operation should be atomic.
+  */
+
+  CollectionAdd& chunkSize(uint64_t max_docs, uint64_t max_bytes)
+  {
+    try {
+      get_impl()->set_chunk_size((row_count_t)max_docs, (size_t)max_bytes);
+      return *this;
+    }
+    CATCH_AND_WRAP
+  }
+
 private:
 
   typedef internal::CollectionAdd_impl Impl;
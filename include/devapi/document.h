@@ -46,6 +46,7 @@ class Value;
 class Field;
 class DbDoc;
 class DocResult;
+class DocList;
 
 
 // Field class
@@ -199,6 +200,7 @@ public:
 
   friend Impl;
   friend DocResult;
+  friend DocList;
   friend Value;
 };
 
@@ -410,6 +412,17 @@ public:
     return m_raw;
   }
 
+  /**
+    Return UTF-8 encoding of a string value.
+
+    For string values read from the server in utf8 or utf8mb4 character
+    set, this returns data received from the server without converting
+    it to a wide string and back. Throws error if this is not a string
+    value.
+  */
+
+  std::string getUtf8() const;
+
 
   /**
     Return type of the value stored in this instance (or VNULL if no
@@ -505,9 +518,20 @@ protected:
   DLL_WARNINGS_PUSH
   bytes  m_raw;
   string m_str;
+  std::string m_utf8;
   std::shared_ptr<Array>  m_arr;
   DLL_WARNINGS_POP
 
+  /*
+    String value is stored either as a wide string in m_str or, if
+    m_has_utf8 is set, as UTF-8 encoded string in m_utf8. The other
+    representation is computed each time it is requested and is not
+    cached, so that const accessors do not modify the value and it can
+    be read from several threads at once.
+  */
+
+  bool m_has_utf8 = false;
+
 public:
 
   friend DbDoc;
@@ -529,7 +553,11 @@ Value& Value::operator=(Value &&other)
 
   switch (m_type)
   {
-  case STRING: m_str = std::move(other.m_str); break;
+  case STRING:
+    m_str = std::move(other.m_str);
+    m_utf8 = std::move(other.m_utf8);
+    m_has_utf8 = other.m_has_utf8;
+    break;
   case DOCUMENT: m_doc = std::move(other.m_doc); break;
   case RAW: m_raw = std::move(other.m_raw); break;
   case ARRAY: m_arr = std::move(other.m_arr); break;
@@ -776,6 +804,17 @@ inline
 Value::operator string() const
 {
   check_type(STRING);
+  if (m_has_utf8)
+    return string(m_utf8);
+  return m_str;
+}
+
+inline
+std::string Value::getUtf8() const
+{
+  check_type(STRING);
+  if (m_has_utf8)
+    return m_utf8;
   return m_str;
 }
 
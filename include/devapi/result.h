@@ -58,6 +58,8 @@ class RowResult;
 class SqlResult;
 class DbDoc;
 class DocResult;
+class RowList;
+class DocList;
 
 template <class Res, class Op> class Executable;
 
@@ -198,6 +200,50 @@ struct iterator
 };
 
 
+/*
+  Iterator over a list whose elements are accessed by position using
+  `operator[]`, such as `RowList` or `DocList`.
+*/
+
+template<typename Value_type, typename List>
+struct List_iterator
+  : std::iterator < std::input_iterator_tag, Value_type>
+{
+  const List *m_list = NULL;
+  size_t m_pos = 0;
+
+  List_iterator(const List &list, size_t pos)
+    : m_list(&list), m_pos(pos)
+  {}
+
+  List_iterator()
+  {}
+
+  bool operator ==(const List_iterator &other) const
+  {
+    return m_pos == other.m_pos;
+  }
+
+  bool operator !=(const List_iterator &other) const
+  {
+    return m_pos != other.m_pos;
+  }
+
+  List_iterator<Value_type, List>& operator++()
+  {
+    ++m_pos;
+    return *this;
+  }
+
+  Value_type operator*() const
+  {
+    if (!m_list)
+      THROW("Attempt to dereference null iterator");
+    return (*m_list)[m_pos];
+  }
+};
+
+
 } // internal
 
 
@@ -301,6 +347,9 @@ namespace internal {
     INTERNAL BaseResult(XSession_base *sess, cdk::Reply*);
     INTERNAL BaseResult(XSession_base *sess, cdk::Reply*,
                         const std::vector<GUID>&);
+    INTERNAL BaseResult(XSession_base *sess, cdk::Reply*,
+                        const std::vector<GUID>&,
+                        const std::vector<cdk::Reply*>&);
 
   protected:
 
@@ -612,6 +661,71 @@ public:
 };
 
 
+/**
+  Exact value of a DECIMAL field as returned by `Row::getDecimal()`.
+
+  The number is equal to `value * 10^(-scale)`.
+
+  @ingroup devapi_res
+*/
+
+struct PUBLIC_API Decimal : public internal::Printable
+{
+  int64_t  value = 0;
+  unsigned scale = 0;
+
+  operator double() const;
+
+private:
+
+  void print(std::ostream&) const;
+};
+
+
+/**
+  Value of a DATE, DATETIME or TIMESTAMP field as returned by
+  `Row::getDatetime()`. For DATE fields the time members are 0.
+
+  @ingroup devapi_res
+*/
+
+struct PUBLIC_API Datetime : public internal::Printable
+{
+  unsigned year = 0;
+  unsigned month = 0;
+  unsigned day = 0;
+  unsigned hour = 0;
+  unsigned minute = 0;
+  unsigned second = 0;
+  unsigned usec = 0;   ///< microseconds
+
+private:
+
+  void print(std::ostream&) const;
+};
+
+
+/**
+  Value of a TIME field as returned by `Row::getTime()`. The number
+  of hours can exceed 24 and the value can be negative.
+
+  @ingroup devapi_res
+*/
+
+struct PUBLIC_API Time : public internal::Printable
+{
+  bool     negative = false;
+  unsigned hours = 0;
+  unsigned minutes = 0;
+  unsigned seconds = 0;
+  unsigned usec = 0;   ///< microseconds
+
+private:
+
+  void print(std::ostream&) const;
+};
+
+
 class RowResult;
 
 /**
@@ -625,7 +739,9 @@ class RowResult;
   Values of fields can be accessed with `get()` method or using
   `row[pos]` expression. Fields are identified by 0-based position.
   It is also possible to get raw bytes representing value of a
-  given field with `getBytes()` method.
+  given field with `getBytes()` method. Values of DECIMAL and temporal
+  fields, which are not decoded by `get()`, can be obtained with
+  `getDecimal()`, `getDatetime()` and `getTime()` methods.
 
   @sa `Value` class.
   @todo Support for iterating over row fields with range-for loop.
@@ -693,6 +809,50 @@ public:
   Value& get(col_count_t pos);
 
 
+  /**
+    Get exact value of DECIMAL field at position `pos`.
+
+    @throws Error if the field is NULL, is not of DECIMAL type or its value
+    does not fit in `Decimal`.
+    @throws out_of_range if given field does not exist in the row data
+    received from server.
+  */
+
+  Decimal getDecimal(col_count_t pos) const;
+
+
+  /**
+    Get value of DATE, DATETIME or TIMESTAMP field at position `pos`.
+
+    @throws Error if the field is NULL or is not of one of these types.
+    @throws out_of_range if given field does not exist in the row data
+    received from server.
+  */
+
+  Datetime getDatetime(col_count_t pos) const;
+
+
+  /**
+    Get value of TIME field at position `pos`.
+
+    @throws Error if the field is NULL or is not of TIME type.
+    @throws out_of_range if given field does not exist in the row data
+    received from server.
+  */
+
+  Time getTime(col_count_t pos) const;
+
+
+  /**
+    Check if row field at position `pos` is NULL.
+
+    Fields which do not exist in the row are also reported as NULL.
+    Unlike `get()`, this does not decode the field value.
+  */
+
+  bool isNull(col_count_t pos) const;
+
+
   /**
     Set value of row field at position `pos`.
 
@@ -741,6 +901,84 @@ public:
 
   void clear();
 
+  friend RowResult;
+  friend RowList;
+};
+
+
+/**
+  List of rows fetched from a result at once.
+
+  Such list is returned by `RowResult::fetchMany()` and
+  `RowResult::fetchAll()`. Rows are stored in an array owned by the list
+  and share the result meta-data. `Row` instances obtained from the list
+  refer to rows in this array without copying row data and keep the whole
+  list alive as long as they exist.
+
+  A list can be used to initialize STL containers of `Row` objects.
+
+  @ingroup devapi_res
+*/
+
+class PUBLIC_API RowList
+{
+  class INTERNAL Impl;
+  DLL_WARNINGS_PUSH
+  std::shared_ptr<Impl>  m_impl;
+  DLL_WARNINGS_POP
+
+public:
+
+  typedef internal::List_iterator<Row, RowList> iterator;
+
+  RowList() {}
+
+  /// Return number of rows in the list.
+
+  size_t size() const;
+
+  /**
+    Return row at given position in the list.
+
+    @throws out_of_range if there is no row at the given position.
+  */
+
+  Row operator[](size_t pos) const;
+
+  iterator begin() const
+  {
+    return iterator(*this, 0);
+  }
+
+  iterator end() const
+  {
+    return iterator(*this, size());
+  }
+
+  /*
+    Note: conversion to std::initializer_list<> must be disabled to avoid
+    ambiguous conversion errors when assigning to STL containers.
+  */
+
+  template <
+    typename U
+    , typename
+      = typename std::is_constructible<
+          U, const iterator&, const iterator&
+        >::type
+    , typename
+      = typename std::enable_if<
+          !std::is_same<
+            U,
+            std::initializer_list<typename U::value_type>
+          >::value
+        >::type
+  >
+  operator U() const
+  {
+    return U(begin(), end());
+  }
+
   friend RowResult;
 };
 
@@ -923,6 +1161,25 @@ public:
 
   Row fetchOne();
 
+  /**
+    Return at most `count` next rows from the result.
+
+    Returned list is empty if there are no more rows in the result.
+  */
+
+  RowList fetchMany(row_count_t count);
+
+  /**
+    Set number of rows which are read from the server at once.
+
+    Rows are fetched from the server in batches of the given size
+    and then returned from memory by `fetchOne()` and other methods.
+    Larger batches reduce the overhead of reading each row, at the cost
+    of memory used to store not yet consumed rows.
+  */
+
+  void setFetchSize(row_count_t size);
+
   /**
     Return all remaining rows
 
@@ -930,13 +1187,7 @@ public:
     calling fetchAll()
    */
 
-
-public:
-
-  internal::List_initializer<RowResult> fetchAll()
-  {
-    return internal::List_initializer<RowResult>(*this);
-  }
+  RowList fetchAll();
 
   /**
      Returns number of rows available on RowResult to be fetched
@@ -1061,6 +1312,78 @@ private:
 // ----------------------
 
 
+/**
+  List of documents fetched from a result at once.
+
+  Such list is returned by `DocResult::fetchMany()` and
+  `DocResult::fetchAll()`. Documents are stored in an array owned by the
+  list. `DbDoc` instances obtained from the list refer to documents in this
+  array without copying them and keep the whole list alive as long as they
+  exist.
+
+  A list can be used to initialize STL containers of `DbDoc` objects.
+
+  @ingroup devapi_res
+*/
+
+class PUBLIC_API DocList
+{
+  class INTERNAL Impl;
+  DLL_WARNINGS_PUSH
+  std::shared_ptr<Impl>  m_impl;
+  DLL_WARNINGS_POP
+
+public:
+
+  typedef internal::List_iterator<DbDoc, DocList> iterator;
+
+  DocList() {}
+
+  /// Return number of documents in the list.
+
+  size_t size() const;
+
+  /**
+    Return document at given position in the list.
+
+    @throws out_of_range if there is no document at the given position.
+  */
+
+  DbDoc operator[](size_t pos) const;
+
+  iterator begin() const
+  {
+    return iterator(*this, 0);
+  }
+
+  iterator end() const
+  {
+    return iterator(*this, size());
+  }
+
+  template <
+    typename U
+    , typename
+      = typename std::is_constructible<
+          U, const iterator&, const iterator&
+        >::type
+    , typename
+      = typename std::enable_if<
+          !std::is_same<
+            U,
+            std::initializer_list<typename U::value_type>
+          >::value
+        >::type
+  >
+  operator U() const
+  {
+    return U(begin(), end());
+  }
+
+  friend DocResult;
+};
+
+
 /**
   %Result of an operation that returns documents.
 
@@ -1109,10 +1432,15 @@ public:
     calling fetchAll()
    */
 
-  internal::List_initializer<DocResult> fetchAll()
-  {
-    return internal::List_initializer<DocResult>(*this);
-  }
+  DocList fetchAll();
+
+  /**
+    Return at most `count` next documents from the result.
+
+    Returned list is empty if there are no more documents in the result.
+  */
+
+  DocList fetchMany(row_count_t count);
 
   /**
      Returns number of documents available on DocResult to be fetched.
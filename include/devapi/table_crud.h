@@ -136,6 +136,13 @@ namespace internal {
       should return empty Row instance to be filled with field data.
     */
     virtual Row& new_row() = 0;
+
+    /*
+      Set limits for the number of rows and the number of bytes
+      sent in a single chunk of the operation (0 means no limit).
+    */
+
+    virtual void set_chunk_size(row_count_t, size_t) = 0;
   };
 
 }  // internal
@@ -337,6 +344,27 @@ public:
     CATCH_AND_WRAP
   }
 
+  /**
+    Limit the number of rows and the number of bytes of row data sent
+    to the server in a single chunk (0 means no limit). Rows are then sent
+    in several chunks which are pipelined and their results are combined
+    into a single Result. By default there are no limits and all rows are
+    inserted by a single command.
+
+    @note If a chunk fails, rows from chunks sent before it are inserted
+    into the table, and so can be rows from up to 3 chunks which were sent
+    after it. Use a transaction if the operation should be atomic.
+  */
+
+  TableInsert& chunkSize(uint64_t max_rows, uint64_t max_bytes)
+  {
+    try {
+      get_impl()->set_chunk_size((row_count_t)max_rows, (size_t)max_bytes);
+      return *this;
+    }
+    CATCH_AND_WRAP
+  }
+
   ///@cond IGNORED
   struct INTERNAL Access;
   friend Access;
@@ -88,6 +88,7 @@ class Session;
 namespace mysqlx {
 
 class XSession;
+class SessionPool;
 class Schema;
 class Collection;
 class Table;
@@ -933,7 +934,9 @@ public:
     PWD,          //!< password
     DB,           //!< default database
     SSL_ENABLE,   //!< use TLS connection
-    SSL_CA        //!< path to a PEM file specifying trusted root certificates
+    SSL_CA,       //!< path to a PEM file specifying trusted root certificates
+    //! path to Unix domain socket of a local server; HOST and PORT are ignored
+    SOCKET
   };
 
 
@@ -961,6 +964,8 @@ public:
 
     - `ssl-enable` : use TLS connection
     - `ssl-ca=`path : path to a PEM file specifying trusted root certificates
+    - `socket=`path : connect to a local server over Unix domain socket
+      at the given path instead of using host and port
 
     Specifying `ssl-ca` option implies `ssl-enable`.
   */
@@ -1218,6 +1223,12 @@ namespace internal {
     */
     INTERNAL XSession_base(XSession_base*);
 
+    /*
+      This constructor takes session from a pool. When such session is
+      closed, it is returned to the pool instead of being terminated.
+    */
+    XSession_base(SessionPool&);
+
     /*
       This notification is sent from parent session when it is closed.
     */
@@ -1346,6 +1357,7 @@ namespace internal {
     ///@cond IGNORE
     friend internal::BaseResult;
     ///@endcond
+    friend SessionPool;
   };
 
 }  // internal
@@ -1415,6 +1427,19 @@ public:
   {}
 
 
+  /**
+    Create session using a connection taken from the given pool.
+
+    When session is closed, its connection is returned to the pool.
+
+    @see `SessionPool`
+  */
+
+  XSession(SessionPool &pool)
+    : XSession_base(pool)
+  {}
+
+
   /*
     Get NodeSession to default shard
   */
@@ -1458,6 +1483,11 @@ public:
   {}
 
 
+  NodeSession(SessionPool &pool)
+    : XSession_base(pool)
+  {}
+
+
 
   /**
     Operation that runs arbitrary SQL query on the node.
@@ -1477,6 +1507,66 @@ private:
 };
 
 
+/**
+  A pool of sessions to a single data store.
+
+  Sessions are created from a pool by passing it to `XSession` or
+  `NodeSession` constructor. When such session is closed (or destroyed),
+  its connection is reset on the server side and returned to the pool
+  so that it can be re-used by another session without the overhead of
+  opening a new connection and authenticating.
+
+  At most `max_size` connections are opened by the pool. If all of them are
+  in use, creating a new session blocks until some other session is closed.
+  The pool opens `min_size` connections when it is created and keeps at
+  least that many open, replacing connections which were closed. Idle
+  connections are closed after `idle_timeout` milliseconds and connections
+  which are open for longer than `max_lifetime` milliseconds are closed
+  when they are idle or returned to the pool. Value 0 of `idle_timeout` or
+  `max_lifetime` means no limit. An idle connection is checked with
+  a round-trip to the server before it is used for a new session.
+
+  Sessions taken from a pool can outlive it - their connections are closed
+  when the session is closed.
+
+  @ingroup devapi
+*/
+
+DLL_WARNINGS_PUSH
+
+class PUBLIC_API SessionPool : internal::nocopy
+{
+
+DLL_WARNINGS_POP
+
+public:
+
+  SessionPool(SessionSettings settings,
+              unsigned max_size = 10,
+              unsigned min_size = 0,
+              unsigned long idle_timeout = 0,
+              unsigned long max_lifetime = 0);
+
+  ~SessionPool();
+
+  /**
+    Close all idle connections and stop handing out new sessions.
+
+    Sessions currently in use are not affected, but their connections
+    are closed instead of being returned to the pool.
+  */
+
+  void close();
+
+private:
+
+  class INTERNAL Impl;
+  std::shared_ptr<Impl> m_impl;
+
+  friend internal::XSession_base;
+};
+
+
 }  // mysqlx
 
 #endif
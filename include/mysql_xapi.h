@@ -301,6 +301,39 @@ typedef enum mysqlx_data_type_enum
   MYSQLX_TYPE_EXPR     = 101  /**< Expression type*/
 } mysqlx_data_type_t;
 
+
+/**
+  Broken-down DATETIME, TIMESTAMP or DATE value as returned by
+  `mysqlx_get_datetime()`. For DATE values the time fields are 0.
+*/
+
+typedef struct mysqlx_datetime_struct
+{
+  uint16_t year;
+  uint8_t  month;
+  uint8_t  day;
+  uint8_t  hour;
+  uint8_t  minute;
+  uint8_t  second;
+  uint32_t usec;    /**< microseconds */
+} mysqlx_datetime_t;
+
+
+/**
+  TIME value as returned by `mysqlx_get_time()`. The number of hours
+  can exceed 24 and the value can be negative.
+*/
+
+typedef struct mysqlx_time_struct
+{
+  uint8_t  negative; /**< 1 if the value is negative, 0 otherwise */
+  uint32_t hours;
+  uint8_t  minutes;
+  uint8_t  seconds;
+  uint32_t usec;     /**< microseconds */
+} mysqlx_time_t;
+
+
 #define PARAM_SINT(A) (void*)MYSQLX_TYPE_SINT, (int64_t)A
 #define PARAM_UINT(A) (void*)MYSQLX_TYPE_UINT, (uint64_t)A
 #define PARAM_FLOAT(A) (void*)MYSQLX_TYPE_FLOAT, (double)A
@@ -2432,6 +2465,68 @@ PUBLIC_API int
 mysqlx_get_double(mysqlx_row_t* row, uint32_t col, double *val);
 
 
+/**
+  Get a DECIMAL number from a row as a fixed-point value.
+
+  The number is equal to `val * 10^(-scale)`. Values of `MYSQLX_TYPE_DECIMAL`
+  columns can be also read with `mysqlx_get_double()` or
+  `mysqlx_get_float()`, possibly loosing precision.
+
+  @param row row handle
+  @param col zero-based column number
+  @param[out] val the pointer to a variable in which to write the
+                  unscaled value
+  @param[out] scale the pointer to a variable in which to write the number
+                    of decimal digits after the decimal point
+
+  @return `RESULT_OK` - on success; `RESULT_NULL` when the column is NULL;
+          `RESULT_ERR` - on error, for example when the value does not
+          fit in 64-bit integer or the column is not of DECIMAL type
+
+  @ingroup xapi_res
+*/
+
+PUBLIC_API int
+mysqlx_get_decimal(mysqlx_row_t* row, uint32_t col,
+                   int64_t *val, uint8_t *scale);
+
+
+/**
+  Get a DATETIME, TIMESTAMP or DATE value from a row.
+
+  @param row row handle
+  @param col zero-based column number
+  @param[out] val the pointer to a structure in which to write the data
+
+  @return `RESULT_OK` - on success; `RESULT_NULL` when the column is NULL;
+          `RESULT_ERR` - on error, for example when the column is of TIME
+          type
+
+  @ingroup xapi_res
+*/
+
+PUBLIC_API int
+mysqlx_get_datetime(mysqlx_row_t* row, uint32_t col, mysqlx_datetime_t *val);
+
+
+/**
+  Get a TIME value from a row.
+
+  @param row row handle
+  @param col zero-based column number
+  @param[out] val the pointer to a structure in which to write the data
+
+  @return `RESULT_OK` - on success; `RESULT_NULL` when the column is NULL;
+          `RESULT_ERR` - on error, for example when the column is not of
+          TIME type
+
+  @ingroup xapi_res
+*/
+
+PUBLIC_API int
+mysqlx_get_time(mysqlx_row_t* row, uint32_t col, mysqlx_time_t *val);
+
+
 /**
   Free the result explicitly.
 
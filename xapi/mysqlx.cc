@@ -927,6 +927,72 @@ int STDCALL mysqlx_get_double(mysqlx_row_t* row, uint32_t col, double *val)
   SAFE_EXCEPTION_END(row, RESULT_ERROR)
 }
 
+int STDCALL mysqlx_get_decimal(mysqlx_row_t* row, uint32_t col,
+                               int64_t *val, uint8_t *scale)
+{
+  SAFE_EXCEPTION_BEGIN(row, RESULT_ERROR)
+  OUT_BUF_CHECK(val, row, MYSQLX_ERROR_OUTPUT_BUFFER_NULL, RESULT_ERROR)
+  OUT_BUF_CHECK(scale, row, MYSQLX_ERROR_OUTPUT_BUFFER_NULL, RESULT_ERROR)
+  CHECK_COLUMN_RANGE(col, row)
+  if (row->get_col_data(col).size() == 0)
+    return RESULT_NULL;
+
+  cdk::Codec<cdk::TYPE_FLOAT> codec(row->get_result().get_cursor()->format(col));
+  cdk::Decimal dec;
+  codec.from_bytes(row->get_col_data(col), dec);
+  *val = dec.m_val;
+  *scale = (uint8_t)dec.m_scale;
+  return RESULT_OK;
+
+  SAFE_EXCEPTION_END(row, RESULT_ERROR)
+}
+
+int STDCALL mysqlx_get_datetime(mysqlx_row_t* row, uint32_t col,
+                                mysqlx_datetime_t *val)
+{
+  SAFE_EXCEPTION_BEGIN(row, RESULT_ERROR)
+  OUT_BUF_CHECK(val, row, MYSQLX_ERROR_OUTPUT_BUFFER_NULL, RESULT_ERROR)
+  CHECK_COLUMN_RANGE(col, row)
+  if (row->get_col_data(col).size() == 0)
+    return RESULT_NULL;
+
+  cdk::Codec<cdk::TYPE_DATETIME> codec(row->get_result().get_cursor()->format(col));
+  cdk::Datetime dt;
+  codec.from_bytes(row->get_col_data(col), dt);
+  val->year = (uint16_t)dt.m_year;
+  val->month = (uint8_t)dt.m_month;
+  val->day = (uint8_t)dt.m_day;
+  val->hour = (uint8_t)dt.m_hour;
+  val->minute = (uint8_t)dt.m_minute;
+  val->second = (uint8_t)dt.m_second;
+  val->usec = dt.m_usec;
+  return RESULT_OK;
+
+  SAFE_EXCEPTION_END(row, RESULT_ERROR)
+}
+
+int STDCALL mysqlx_get_time(mysqlx_row_t* row, uint32_t col,
+                            mysqlx_time_t *val)
+{
+  SAFE_EXCEPTION_BEGIN(row, RESULT_ERROR)
+  OUT_BUF_CHECK(val, row, MYSQLX_ERROR_OUTPUT_BUFFER_NULL, RESULT_ERROR)
+  CHECK_COLUMN_RANGE(col, row)
+  if (row->get_col_data(col).size() == 0)
+    return RESULT_NULL;
+
+  cdk::Codec<cdk::TYPE_DATETIME> codec(row->get_result().get_cursor()->format(col));
+  cdk::Time tm;
+  codec.from_bytes(row->get_col_data(col), tm);
+  val->negative = tm.m_negative ? 1 : 0;
+  val->hours = tm.m_hours;
+  val->minutes = (uint8_t)tm.m_minutes;
+  val->seconds = (uint8_t)tm.m_seconds;
+  val->usec = tm.m_usec;
+  return RESULT_OK;
+
+  SAFE_EXCEPTION_END(row, RESULT_ERROR)
+}
+
 /*
   Get the number of columns in the result
   PARAMETERS:
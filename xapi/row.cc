@@ -196,13 +196,7 @@ void Row_item::generate_uuid()
 
     mysqlx::generate_uuid(uuid);
     char buf[sizeof(uuid::uuid_type)* 2 + 1];
-    const char digits[17] = { "0123456789ABCDEF" };
-
-    for (size_t i = 0; i < sizeof(uuid); ++i)
-    {
-      buf[i * 2] = digits[((unsigned char)uuid[i]) & 0x0F];
-      buf[i * 2 + 1] = digits[((unsigned char)uuid[i] >> 4)];
-    }
+    uuid::to_hex(uuid, buf);
     buf[sizeof(uuid::uuid_type)* 2] = 0; // put a string termination
     m_uuid = buf;
   }
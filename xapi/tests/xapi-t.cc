@@ -497,6 +497,62 @@ TEST_F(xapi, store_result_select)
 
 }
 
+TEST_F(xapi, decimal_datetime)
+{
+  SKIP_IF_NO_XPLUGIN
+
+  mysqlx_stmt_t *stmt;
+  mysqlx_result_t *res;
+  mysqlx_row_t *row;
+
+  const char * query =
+    "SELECT CAST(-123.4500 AS DECIMAL(10,4)),"
+    " CAST('2016-11-04 12:34:56.789' AS DATETIME(3)),"
+    " CAST('-26:01:02' AS TIME), CAST('2016-02-29' AS DATE)";
+
+  AUTHENTICATE();
+
+  RESULT_CHECK(stmt = mysqlx_sql_new(get_session(), query, strlen(query)));
+  CRUD_CHECK(res = mysqlx_execute(stmt), stmt);
+
+  EXPECT_TRUE((row = mysqlx_row_fetch_one(res)) != NULL);
+
+  int64_t dec_val = 0;
+  uint8_t dec_scale = 0;
+  EXPECT_EQ(RESULT_OK, mysqlx_get_decimal(row, 0, &dec_val, &dec_scale));
+  EXPECT_EQ(-1234500, dec_val);
+  EXPECT_EQ(4, dec_scale);
+
+  double dbl = 0;
+  EXPECT_EQ(RESULT_OK, mysqlx_get_double(row, 0, &dbl));
+  EXPECT_DOUBLE_EQ(-123.45, dbl);
+
+  mysqlx_datetime_t dt;
+  EXPECT_EQ(RESULT_OK, mysqlx_get_datetime(row, 1, &dt));
+  EXPECT_EQ(2016, dt.year);
+  EXPECT_EQ(11, dt.month);
+  EXPECT_EQ(4, dt.day);
+  EXPECT_EQ(12, dt.hour);
+  EXPECT_EQ(34, dt.minute);
+  EXPECT_EQ(56, dt.second);
+  EXPECT_EQ(789000U, dt.usec);
+
+  mysqlx_time_t tm;
+  EXPECT_EQ(RESULT_OK, mysqlx_get_time(row, 2, &tm));
+  EXPECT_EQ(1, tm.negative);
+  EXPECT_EQ(26U, tm.hours);
+  EXPECT_EQ(1, tm.minutes);
+  EXPECT_EQ(2, tm.seconds);
+
+  EXPECT_EQ(RESULT_ERROR, mysqlx_get_time(row, 1, &tm));
+
+  EXPECT_EQ(RESULT_OK, mysqlx_get_datetime(row, 3, &dt));
+  EXPECT_EQ(2016, dt.year);
+  EXPECT_EQ(2, dt.month);
+  EXPECT_EQ(29, dt.day);
+  EXPECT_EQ(0, dt.hour);
+}
+
 TEST_F(xapi, store_result_find)
 {
   SKIP_IF_NO_XPLUGIN